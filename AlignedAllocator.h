@@ -0,0 +1,111 @@
+#ifndef ALIGNEDALLOCATOR_H_INCLUDED
+#define ALIGNEDALLOCATOR_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+static const size_t ALIGNED_CACHE_LINE = 64;             ///< Alignment of every block, one cache line
+static const size_t ALIGNED_HUGE_PAGE = 2 * 1024 * 1024;  ///< Size of a transparent huge page
+
+/**
+ * @class AlignedAllocator
+ * @brief Standard allocator for bulk storage, cache-line aligned and backed by huge pages
+ *
+ * Every block is aligned to 64 bytes, so SIMD loads never straddle a cache line. Blocks of at
+ * least 2 MiB are mapped directly with `mmap`, aligned to a huge page and marked with
+ * `MADV_HUGEPAGE`, so scanning a multi-gigabyte array needs 512 times fewer TLB entries.
+ * Mapped blocks are never written by the allocator, so on a NUMA machine each page is placed on
+ * the node of the thread that first writes it. Filling a large array from the threads that
+ * will scan it, as `Weather::loadDataFromFiles` does, keeps the pages near their readers.
+ *
+ * Huge pages only apply on Linux; on other systems every block comes from the aligned
+ * `operator new`.
+ *
+ * It can be plugged into `Vector`, `SegmentedVector` or any standard container.
+ *
+ * @tparam T The type of the allocated elements.
+ */
+template <class T>
+class AlignedAllocator
+{
+public:
+    typedef T value_type;
+
+    AlignedAllocator() noexcept {}
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U>&) noexcept {}
+
+    /**
+     * @brief Allocates uninitialised storage for a number of elements
+     *
+     * @param n The number of elements.
+     * @return A 64-byte aligned pointer to the storage.
+     * @throw std::bad_alloc If the memory cannot be allocated.
+     */
+    T* allocate(size_t n)
+    {
+        size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+        if (bytes >= ALIGNED_HUGE_PAGE)
+            return static_cast<T*>(mapHugePages(roundToHugePage(bytes)));
+#endif
+        return static_cast<T*>(::operator new(bytes, std::align_val_t(ALIGNED_CACHE_LINE)));
+    }
+
+    /**
+     * @brief Frees storage returned by `allocate`
+     *
+     * @param block The pointer returned by `allocate`.
+     * @param n The number of elements passed to `allocate`.
+     */
+    void deallocate(T* block, size_t n) noexcept
+    {
+        size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+        if (bytes >= ALIGNED_HUGE_PAGE)
+        {
+            munmap(block, roundToHugePage(bytes));
+            return;
+        }
+#endif
+        ::operator delete(block, std::align_val_t(ALIGNED_CACHE_LINE));
+    }
+
+    bool operator==(const AlignedAllocator&) const noexcept { return true; }   ///< Stateless, all equal
+    bool operator!=(const AlignedAllocator&) const noexcept { return false; }
+
+private:
+    static size_t roundToHugePage(size_t bytes)
+    {
+        return (bytes + ALIGNED_HUGE_PAGE - 1) & ~(ALIGNED_HUGE_PAGE - 1);
+    }
+
+#if defined(__linux__)
+    static void* mapHugePages(size_t bytes)
+    {
+        // Map one huge page more than needed, then trim both ends to a huge page boundary
+        size_t mapped = bytes + ALIGNED_HUGE_PAGE;
+        void* region = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED)
+            throw std::bad_alloc();
+        std::uintptr_t start = reinterpret_cast<std::uintptr_t>(region);
+        std::uintptr_t aligned = (start + ALIGNED_HUGE_PAGE - 1) & ~static_cast<std::uintptr_t>(ALIGNED_HUGE_PAGE - 1);
+        if (aligned > start)
+            munmap(region, aligned - start);
+        if (aligned + bytes < start + mapped)
+            munmap(reinterpret_cast<void*>(aligned + bytes), start + mapped - aligned - bytes);
+        void* block = reinterpret_cast<void*>(aligned);
+#if defined(MADV_HUGEPAGE)
+        madvise(block, bytes, MADV_HUGEPAGE);  // Only a hint, ignored when huge pages are disabled
+#endif
+        return block;
+    }
+#endif
+};
+
+#endif // ALIGNEDALLOCATOR_H_INCLUDED
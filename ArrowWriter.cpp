@@ -0,0 +1,452 @@
+#include "ArrowWriter.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const size_t BUFFER_ALIGNMENT = 64;  ///< Alignment of every buffer of a record batch body
+    const int16_t METADATA_V5 = 4;       ///< Arrow metadata version written to every message
+
+    // Header types of a message
+    const uint8_t HEADER_SCHEMA = 1;
+    const uint8_t HEADER_RECORD_BATCH = 3;
+
+    // Type ids of a field
+    const uint8_t TYPE_INT = 2;
+    const uint8_t TYPE_FLOATING_POINT = 3;
+    const uint8_t TYPE_UTF8 = 5;
+    const uint8_t TYPE_DATE = 8;
+    const uint8_t TYPE_TIMESTAMP = 10;
+
+    size_t padTo(size_t length, size_t alignment)
+    {
+        return (length + alignment - 1) / alignment * alignment;
+    }
+
+    /**
+     * @brief Minimal FlatBuffers encoder for the Arrow metadata
+     *
+     * A FlatBuffer is built back to front: strings, vectors and tables are written before the
+     * objects that refer to them, and each is identified by its distance from the end of the
+     * buffer. Every table gets its own vtable, written right in front of it.
+     */
+    class FlatBufferBuilder
+    {
+    public:
+        FlatBufferBuilder() : m_buffer(1024), m_head(m_buffer.size()), m_minAlign(1), m_tableStart(0) {}
+
+        size_t size() const { return m_buffer.size() - m_head; }
+
+        uint32_t createString(const string& text)
+        {
+            align(text.size() + 1, 4);
+            push<uint8_t>(0);
+            pushBytes(text.data(), text.size());
+            push<uint32_t>(static_cast<uint32_t>(text.size()));
+            return static_cast<uint32_t>(size());
+        }
+
+        uint32_t createOffsetVector(const std::vector<uint32_t>& targets)
+        {
+            align(targets.size() * 4, 4);
+            for (size_t i = targets.size(); i-- > 0;)
+                push<uint32_t>(static_cast<uint32_t>(size() + 4 - targets[i]));
+            push<uint32_t>(static_cast<uint32_t>(targets.size()));
+            return static_cast<uint32_t>(size());
+        }
+
+        /// Vector of structs made of 64-bit fields, given as consecutive values
+        uint32_t createStructVector(const std::vector<int64_t>& fields, size_t fieldsPerStruct)
+        {
+            align(fields.size() * 8, 8);
+            pushBytes(fields.data(), fields.size() * 8);
+            push<uint32_t>(static_cast<uint32_t>(fields.size() / fieldsPerStruct));
+            return static_cast<uint32_t>(size());
+        }
+
+        void startTable()
+        {
+            m_fields.clear();
+            m_tableStart = size();
+        }
+
+        template <class T>
+        void addScalar(uint16_t slot, T value)
+        {
+            align(sizeof(T), sizeof(T));
+            push<T>(value);
+            m_fields.push_back({slot, size()});
+        }
+
+        void addOffset(uint16_t slot, uint32_t target)
+        {
+            align(4, 4);
+            push<uint32_t>(static_cast<uint32_t>(size() + 4 - target));
+            m_fields.push_back({slot, size()});
+        }
+
+        uint32_t endTable()
+        {
+            align(4, 4);
+            push<int32_t>(0);  // Offset to the vtable, patched below
+            size_t table = size();
+
+            uint16_t slots = 0;
+            for (const Field& field : m_fields)
+                slots = std::max<uint16_t>(slots, field.slot + 1);
+            std::vector<uint16_t> entries(slots, 0);
+            for (const Field& field : m_fields)
+                entries[field.slot] = static_cast<uint16_t>(table - field.position);
+
+            for (size_t i = slots; i-- > 0;)
+                push<uint16_t>(entries[i]);
+            push<uint16_t>(static_cast<uint16_t>(table - m_tableStart));
+            push<uint16_t>(static_cast<uint16_t>((slots + 2) * 2));
+
+            int32_t vtableOffset = static_cast<int32_t>(size() - table);
+            std::memcpy(&m_buffer[m_buffer.size() - table], &vtableOffset, 4);
+            return static_cast<uint32_t>(table);
+        }
+
+        /// Writes the offset of the root table and returns the buffer, padded to 8 bytes
+        std::vector<uint8_t> finish(uint32_t root)
+        {
+            align(4, std::max<size_t>(m_minAlign, 8));
+            push<uint32_t>(static_cast<uint32_t>(size() + 4 - root));
+            return std::vector<uint8_t>(m_buffer.begin() + m_head, m_buffer.end());
+        }
+
+    private:
+        struct Field
+        {
+            uint16_t slot;
+            size_t position;
+        };
+
+        std::vector<uint8_t> m_buffer;  ///< The FlatBuffer occupies the end, from `m_head`
+        size_t m_head;                  ///< Start of the data written so far
+        size_t m_minAlign;              ///< Largest alignment required by any value
+        size_t m_tableStart;            ///< Size of the buffer when the open table was started
+        std::vector<Field> m_fields;    ///< Fields of the open table
+
+        /// Pads so that `bytes` more bytes end on a multiple of `alignment` from the end
+        void align(size_t bytes, size_t alignment)
+        {
+            m_minAlign = std::max(m_minAlign, alignment);
+            size_t padding = (alignment - (size() + bytes) % alignment) % alignment;
+            reserve(padding);
+            m_head -= padding;
+            std::memset(&m_buffer[m_head], 0, padding);
+        }
+
+        void reserve(size_t bytes)
+        {
+            if (m_head >= bytes)
+                return;
+            size_t used = size();
+            std::vector<uint8_t> larger(std::max(m_buffer.size() * 2, used + bytes));
+            std::copy(m_buffer.begin() + m_head, m_buffer.end(), larger.end() - used);
+            m_buffer.swap(larger);
+            m_head = m_buffer.size() - used;
+        }
+
+        template <class T>
+        void push(T value)
+        {
+            pushBytes(&value, sizeof(T));
+        }
+
+        void pushBytes(const void* bytes, size_t length)
+        {
+            reserve(length);
+            m_head -= length;
+            if (length > 0)
+                std::memcpy(&m_buffer[m_head], bytes, length);
+        }
+    };
+
+    uint32_t buildType(FlatBufferBuilder& builder, ArrowType type, uint8_t& typeId)
+    {
+        builder.startTable();
+        switch (type)
+        {
+            case ArrowType::Int32:
+            case ArrowType::Int64:
+                typeId = TYPE_INT;
+                builder.addScalar<int32_t>(0, type == ArrowType::Int32 ? 32 : 64);  // bitWidth
+                builder.addScalar<uint8_t>(1, 1);                                    // is_signed
+                break;
+            case ArrowType::Float32:
+            case ArrowType::Float64:
+                typeId = TYPE_FLOATING_POINT;
+                builder.addScalar<int16_t>(0, type == ArrowType::Float32 ? 1 : 2);  // SINGLE or DOUBLE
+                break;
+            case ArrowType::Date32:
+                typeId = TYPE_DATE;
+                builder.addScalar<int16_t>(0, 0);  // DAY, not the default MILLISECOND
+                break;
+            case ArrowType::TimestampSecond:
+                typeId = TYPE_TIMESTAMP;
+                builder.addScalar<int16_t>(0, 0);  // SECOND, no time zone
+                break;
+            case ArrowType::Utf8:
+                typeId = TYPE_UTF8;
+                break;
+        }
+        return builder.endTable();
+    }
+
+    uint32_t buildSchema(FlatBufferBuilder& builder, const std::vector<ArrowColumn>& schema)
+    {
+        std::vector<uint32_t> fields;
+        for (const ArrowColumn& column : schema)
+        {
+            uint32_t name = builder.createString(column.name());
+            uint8_t typeId = 0;
+            uint32_t type = buildType(builder, column.type(), typeId);
+            uint32_t children = builder.createOffsetVector({});
+
+            builder.startTable();
+            builder.addOffset(0, name);
+            builder.addScalar<uint8_t>(1, column.isNullable());
+            builder.addScalar<uint8_t>(2, typeId);
+            builder.addOffset(3, type);
+            builder.addOffset(5, children);
+            fields.push_back(builder.endTable());
+        }
+        uint32_t fieldVector = builder.createOffsetVector(fields);
+
+        builder.startTable();
+        builder.addScalar<int16_t>(0, 0);  // Little-endian
+        builder.addOffset(1, fieldVector);
+        return builder.endTable();
+    }
+
+    uint32_t buildMessage(FlatBufferBuilder& builder, uint8_t headerType, uint32_t header, int64_t bodyLength)
+    {
+        builder.startTable();
+        builder.addScalar<int16_t>(0, METADATA_V5);
+        builder.addScalar<uint8_t>(1, headerType);
+        builder.addOffset(2, header);
+        builder.addScalar<int64_t>(3, bodyLength);
+        return builder.endTable();
+    }
+}
+
+ArrowColumn::ArrowColumn(const string& name, ArrowType type, bool nullable)
+    : m_name(name), m_type(type), m_nullable(nullable), m_length(0), m_nullCount(0)
+{
+    if (m_type == ArrowType::Utf8)
+        m_offsets.push_back(0);
+}
+
+size_t ArrowColumn::byteWidth(ArrowType type)
+{
+    switch (type)
+    {
+        case ArrowType::Int32:
+        case ArrowType::Float32:
+        case ArrowType::Date32:
+            return 4;
+        case ArrowType::Int64:
+        case ArrowType::Float64:
+        case ArrowType::TimestampSecond:
+            return 8;
+        case ArrowType::Utf8:
+            break;
+    }
+    return 0;
+}
+
+void ArrowColumn::appendValidity(bool valid)
+{
+    if (m_length % 8 == 0)
+        m_validity.push_back(0);
+    if (valid)
+        m_validity.back() |= static_cast<uint8_t>(1u << (m_length % 8));
+    else
+        m_nullCount++;
+    m_length++;
+}
+
+void ArrowColumn::appendString(const string& value)
+{
+    if (m_type != ArrowType::Utf8)
+        throw std::invalid_argument("ArrowColumn::appendString: " + m_name + " does not hold strings");
+    m_values.insert(m_values.end(), value.begin(), value.end());
+    m_offsets.push_back(static_cast<int32_t>(m_values.size()));
+    appendValidity(true);
+}
+
+void ArrowColumn::appendNull()
+{
+    if (!m_nullable)
+        throw std::invalid_argument("ArrowColumn::appendNull: " + m_name + " is not nullable");
+    if (m_type == ArrowType::Utf8)
+        m_offsets.push_back(static_cast<int32_t>(m_values.size()));
+    else
+        m_values.resize(m_values.size() + byteWidth(m_type), 0);
+    appendValidity(false);
+}
+
+void ArrowColumn::clear()
+{
+    m_length = 0;
+    m_nullCount = 0;
+    m_validity.clear();
+    m_values.clear();
+    m_offsets.clear();
+    if (m_type == ArrowType::Utf8)
+        m_offsets.push_back(0);
+}
+
+ArrowFileWriter::ArrowFileWriter(const string& filename, const std::vector<ArrowColumn>& schema)
+    : m_file(std::fopen(filename.c_str(), "wb")), m_ok(m_file != nullptr), m_position(0)
+{
+    for (const ArrowColumn& column : schema)
+        m_schema.emplace_back(column.name(), column.type(), column.isNullable());
+
+    const char magic[8] = {'A', 'R', 'R', 'O', 'W', '1', 0, 0};  // Padded to 8 bytes
+    write(magic, sizeof(magic));
+
+    FlatBufferBuilder builder;
+    uint32_t schemaTable = buildSchema(builder, m_schema);
+    writeMessage(builder.finish(buildMessage(builder, HEADER_SCHEMA, schemaTable, 0)));
+}
+
+ArrowFileWriter::~ArrowFileWriter()
+{
+    close();
+}
+
+bool ArrowFileWriter::isOpen() const
+{
+    return m_file != nullptr && m_ok;
+}
+
+void ArrowFileWriter::write(const void* bytes, size_t length)
+{
+    if (m_file == nullptr || length == 0)
+        return;
+    m_ok &= std::fwrite(bytes, 1, length, m_file) == length;
+    m_position += static_cast<int64_t>(length);
+}
+
+void ArrowFileWriter::writePadding(size_t length)
+{
+    static const uint8_t zeros[BUFFER_ALIGNMENT] = {};
+    write(zeros, length);
+}
+
+void ArrowFileWriter::writeMessage(const std::vector<uint8_t>& metadata)
+{
+    // Continuation marker and metadata length; the FlatBuffer is already a multiple of 8 bytes
+    const uint32_t continuation = 0xFFFFFFFF;
+    int32_t length = static_cast<int32_t>(metadata.size());
+    write(&continuation, 4);
+    write(&length, 4);
+    write(metadata.data(), metadata.size());
+}
+
+bool ArrowFileWriter::writeBatch(const std::vector<ArrowColumn>& columns)
+{
+    if (columns.size() != m_schema.size())
+        throw std::invalid_argument("ArrowFileWriter::writeBatch: wrong number of columns");
+    size_t rows = columns.empty() ? 0 : columns[0].size();
+    for (size_t i = 0; i < columns.size(); i++)
+        if (columns[i].type() != m_schema[i].type() || columns[i].size() != rows)
+            throw std::invalid_argument("ArrowFileWriter::writeBatch: column " + columns[i].name()
+                                        + " does not match the schema");
+    if (m_file == nullptr)
+        return false;
+
+    // Lay out the body: validity bitmap, then offsets for strings, then values, each padded
+    std::vector<std::pair<const void*, size_t>> buffers;
+    for (const ArrowColumn& column : columns)
+    {
+        buffers.emplace_back(column.m_validity.data(), column.m_validity.size());
+        if (column.type() == ArrowType::Utf8)
+            buffers.emplace_back(column.m_offsets.data(), column.m_offsets.size() * sizeof(int32_t));
+        buffers.emplace_back(column.m_values.data(), column.m_values.size());
+    }
+
+    std::vector<int64_t> nodes;
+    std::vector<int64_t> bufferSpans;
+    for (const ArrowColumn& column : columns)
+    {
+        nodes.push_back(static_cast<int64_t>(column.size()));
+        nodes.push_back(static_cast<int64_t>(column.nullCount()));
+    }
+    int64_t bodyLength = 0;
+    for (const std::pair<const void*, size_t>& buffer : buffers)
+    {
+        bufferSpans.push_back(bodyLength);
+        bufferSpans.push_back(static_cast<int64_t>(buffer.second));
+        bodyLength += static_cast<int64_t>(padTo(buffer.second, BUFFER_ALIGNMENT));
+    }
+
+    FlatBufferBuilder builder;
+    uint32_t nodeVector = builder.createStructVector(nodes, 2);
+    uint32_t bufferVector = builder.createStructVector(bufferSpans, 2);
+    builder.startTable();
+    builder.addScalar<int64_t>(0, static_cast<int64_t>(rows));
+    builder.addOffset(1, nodeVector);
+    builder.addOffset(2, bufferVector);
+    uint32_t recordBatch = builder.endTable();
+    std::vector<uint8_t> metadata = builder.finish(buildMessage(builder, HEADER_RECORD_BATCH, recordBatch, bodyLength));
+
+    // The body must start on a 64-byte boundary of the file, so pad the metadata accordingly
+    size_t prefixed = 8 + metadata.size();
+    metadata.resize(padTo(static_cast<size_t>(m_position) + prefixed, BUFFER_ALIGNMENT)
+                    - static_cast<size_t>(m_position) - 8, 0);
+
+    Block block;
+    block.offset = m_position;
+    block.metadataLength = static_cast<int32_t>(8 + metadata.size());
+    block.bodyLength = bodyLength;
+    writeMessage(metadata);
+    for (const std::pair<const void*, size_t>& buffer : buffers)
+    {
+        write(buffer.first, buffer.second);
+        writePadding(padTo(buffer.second, BUFFER_ALIGNMENT) - buffer.second);
+    }
+    m_batches.push_back(block);
+    return m_ok;
+}
+
+bool ArrowFileWriter::close()
+{
+    if (m_file == nullptr)
+        return false;
+
+    // End-of-stream marker, then the footer listing the schema and every record batch
+    const uint32_t endOfStream[2] = {0xFFFFFFFF, 0};
+    write(endOfStream, sizeof(endOfStream));
+
+    FlatBufferBuilder builder;
+    uint32_t schemaTable = buildSchema(builder, m_schema);
+    std::vector<int64_t> blocks;
+    for (const Block& block : m_batches)
+    {
+        blocks.push_back(block.offset);
+        blocks.push_back(block.metadataLength);  // Followed by 4 bytes of padding, zero here
+        blocks.push_back(block.bodyLength);
+    }
+    uint32_t dictionaries = builder.createStructVector({}, 3);
+    uint32_t batchVector = builder.createStructVector(blocks, 3);
+    builder.startTable();
+    builder.addScalar<int16_t>(0, METADATA_V5);
+    builder.addOffset(1, schemaTable);
+    builder.addOffset(2, dictionaries);
+    builder.addOffset(3, batchVector);
+    std::vector<uint8_t> footer = builder.finish(builder.endTable());
+
+    int32_t footerLength = static_cast<int32_t>(footer.size());
+    write(footer.data(), footer.size());
+    write(&footerLength, 4);
+    write("ARROW1", 6);
+
+    m_ok &= std::fclose(m_file) == 0;
+    m_file = nullptr;
+    return m_ok;
+}
@@ -0,0 +1,187 @@
+#ifndef ARROWWRITER_H_INCLUDED
+#define ARROWWRITER_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using std::string;
+
+/**
+ * @brief Column types that can be exported to Arrow
+ */
+enum class ArrowType
+{
+    Int32,            ///< 32-bit signed integer
+    Int64,            ///< 64-bit signed integer
+    Float32,          ///< Single-precision floating point
+    Float64,          ///< Double-precision floating point
+    Date32,           ///< Days since 1 January 1970, stored as a 32-bit integer
+    TimestampSecond,  ///< Seconds since 1 January 1970 without a time zone, stored as a 64-bit integer
+    Utf8              ///< Variable-length UTF-8 string
+};
+
+/**
+ * @class ArrowColumn
+ * @brief One column of an Arrow record batch, built value by value
+ *
+ * Values are stored exactly as Arrow lays them out in memory: a validity bitmap with one bit
+ * per value, least significant bit first, and a contiguous array of fixed-width values, or
+ * for strings an array of 32-bit offsets into one block of characters.
+ */
+class ArrowColumn
+{
+public:
+    /**
+     * @brief Creates an empty column
+     *
+     * @param name The name of the column.
+     * @param type The type of the values.
+     * @param nullable Whether the column may hold null values.
+     */
+    ArrowColumn(const string& name, ArrowType type, bool nullable);
+
+    /**
+     * @brief Appends a fixed-width value
+     *
+     * @param value The value, of a C++ type with the width of the column type (e.g. `int32_t`
+     *              for `Int32` and `Date32`, `float` for `Float32`).
+     * @throw std::invalid_argument If the column holds strings or the value has the wrong width.
+     */
+    template <class T>
+    void append(T value);
+
+    /**
+     * @brief Appends a string
+     *
+     * @param value The string.
+     * @throw std::invalid_argument If the column does not hold strings.
+     */
+    void appendString(const string& value);
+
+    /**
+     * @brief Appends a null value
+     *
+     * @throw std::invalid_argument If the column is not nullable.
+     */
+    void appendNull();
+
+    /**
+     * @brief Removes every value, keeping the name and type
+     */
+    void clear();
+
+    const string& name() const { return m_name; }      ///< Name of the column
+    ArrowType type() const { return m_type; }          ///< Type of the values
+    bool isNullable() const { return m_nullable; }     ///< Whether the column may hold nulls
+    size_t size() const { return m_length; }           ///< Number of values, nulls included
+    size_t nullCount() const { return m_nullCount; }   ///< Number of null values
+
+private:
+    friend class ArrowFileWriter;
+
+    string m_name;                   ///< Name of the column
+    ArrowType m_type;                ///< Type of the values
+    bool m_nullable;                 ///< Whether the column may hold nulls
+    size_t m_length;                 ///< Number of values
+    size_t m_nullCount;              ///< Number of null values
+    std::vector<uint8_t> m_validity; ///< One bit per value, set when the value is not null
+    std::vector<uint8_t> m_values;   ///< Fixed-width values, or the characters of the strings
+    std::vector<int32_t> m_offsets;  ///< Start of each string in `m_values`, then the end of the last one
+
+    static size_t byteWidth(ArrowType type);
+    void appendValidity(bool valid);
+};
+
+/**
+ * @class ArrowFileWriter
+ * @brief Writes record batches to a file in the Apache Arrow IPC file format
+ *
+ * The file can be memory-mapped and read by any Arrow implementation (pyarrow, Spark, ...)
+ * without parsing: every buffer is written in Arrow's in-memory layout and aligned to 64 bytes.
+ * The metadata (schema, record batch headers and footer) is encoded as FlatBuffers by a small
+ * builder in the implementation, so no Arrow or FlatBuffers library is needed.
+ *
+ * All batches of a file share the schema given when the file is created.
+ */
+class ArrowFileWriter
+{
+public:
+    /**
+     * @brief Creates or truncates a file and writes its header and schema
+     *
+     * @param filename The name of the file.
+     * @param schema Columns giving the name, type and nullability of every field; their values
+     *               are ignored.
+     */
+    ArrowFileWriter(const string& filename, const std::vector<ArrowColumn>& schema);
+
+    /**
+     * @brief Destructor
+     *
+     * Closes the file if `close` was not called.
+     */
+    ~ArrowFileWriter();
+
+    ArrowFileWriter(const ArrowFileWriter&) = delete;
+    ArrowFileWriter& operator=(const ArrowFileWriter&) = delete;
+
+    /**
+     * @brief Checks if the file could be created
+     *
+     * @return `true` if the file is open and no write failed.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Writes one record batch
+     *
+     * @param columns The columns of the batch, in schema order and all of the same length.
+     * @return `true` if the batch was written.
+     * @throw std::invalid_argument If the columns do not match the schema.
+     */
+    bool writeBatch(const std::vector<ArrowColumn>& columns);
+
+    /**
+     * @brief Writes the footer and closes the file
+     *
+     * @return `true` if the whole file was written.
+     */
+    bool close();
+
+private:
+    /// Location of a message in the file, as listed in the footer
+    struct Block
+    {
+        int64_t offset;          ///< Start of the message
+        int32_t metadataLength;  ///< Length of the message prefix and metadata
+        int64_t bodyLength;      ///< Length of the message body
+    };
+
+    FILE* m_file;                       ///< Destination file
+    bool m_ok;                          ///< Whether every write succeeded
+    int64_t m_position;                 ///< Number of bytes written
+    std::vector<ArrowColumn> m_schema;  ///< Fields of the file, without values
+    std::vector<Block> m_batches;       ///< Every record batch written
+
+    void write(const void* bytes, size_t length);
+    void writePadding(size_t length);
+    void writeMessage(const std::vector<uint8_t>& metadata);
+};
+
+template <class T>
+void ArrowColumn::append(T value)
+{
+    static_assert(std::is_arithmetic<T>::value, "Arrow values are numbers or strings");
+    if (m_type == ArrowType::Utf8 || sizeof(T) != byteWidth(m_type))
+        throw std::invalid_argument("ArrowColumn::append: value does not match the type of " + m_name);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    m_values.insert(m_values.end(), bytes, bytes + sizeof(T));
+    appendValidity(true);
+}
+
+#endif // ARROWWRITER_H_INCLUDED
@@ -0,0 +1,769 @@
+#ifndef BPLUSTREE_H_INCLUDED
+#define BPLUSTREE_H_INCLUDED
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Bst.h"
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Count the keys of a sorted node that are less than (or equal to) a value
+ *
+ * Since the keys are sorted this is the position of the value in the node. All the keys are
+ * compared without branching, which lets the compiler vectorize the loop; `float` and `int`
+ * keys use SSE2 explicitly and compare four keys per instruction.
+ *
+ * @param keys The sorted keys of the node.
+ * @param n The number of keys.
+ * @param value The value to locate.
+ * @param orEqual Whether keys equal to `value` are counted.
+ * @return The number of keys less than (or equal to) `value`.
+ */
+template <class T>
+inline int bplusRank(const T* keys, int n, const T& value, bool orEqual)
+{
+    int rank = 0;
+    for (int i = 0; i < n; i++)
+        rank += orEqual ? !(value < keys[i]) : (keys[i] < value);
+    return rank;
+}
+
+#if defined(__SSE2__) && defined(__GNUC__)
+inline int bplusRank(const float* keys, int n, const float& value, bool orEqual)
+{
+    __m128 needle = _mm_set1_ps(value);
+    int rank = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 block = _mm_loadu_ps(keys + i);
+        __m128 mask = orEqual ? _mm_cmple_ps(block, needle) : _mm_cmplt_ps(block, needle);
+        rank += __builtin_popcount(_mm_movemask_ps(mask));
+    }
+    for (; i < n; i++)
+        rank += orEqual ? !(value < keys[i]) : (keys[i] < value);
+    return rank;
+}
+
+inline int bplusRank(const int* keys, int n, const int& value, bool orEqual)
+{
+    int rank = 0;
+    int i = 0;
+    if (orEqual || value != (-2147483647 - 1))  // value - 1 would overflow for INT_MIN, nothing is less
+    {
+        // key < value is key <= value - 1, so both cases count the keys not greater than the needle
+        __m128i needle = _mm_set1_epi32(orEqual ? value : value - 1);
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+            __m128i greater = _mm_cmpgt_epi32(block, needle);
+            rank += 4 - __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(greater)));
+        }
+    }
+    for (; i < n; i++)
+        rank += orEqual ? !(value < keys[i]) : (keys[i] < value);
+    return rank;
+}
+#endif
+
+/**
+ * @class BPlusTree
+ * @brief Ordered multiset stored as a B+-tree with wide, cache-friendly nodes
+ *
+ * This class is an alternative to `Bst` for large in-memory sets. Each node is a few cache
+ * lines wide and holds dozens of sorted keys, so a lookup touches a handful of nodes instead
+ * of one node per binary level, and the in-node search compares keys with SIMD instead of
+ * chasing pointers. Values live only in the leaves, which are linked in order, so an in-order
+ * traversal is a linear scan.
+ *
+ * Like `Bst`, the tree is a multiset: each leaf entry stores a distinct value with its
+ * multiplicity. It exposes the same insert/remove/search/count/sum/inOrder interface.
+ *
+ * @tparam T The type of the stored values (e.g., int, float).
+ */
+template <class T>
+class BPlusTree
+{
+public:
+    BPlusTree();                                            ///< Constructor for BPlusTree
+    ~BPlusTree();                                           ///< Destructor for BPlusTree
+    BPlusTree(const BPlusTree<T>& other);                   ///< Copy constructor
+    BPlusTree<T>& operator=(const BPlusTree<T>& other);     ///< Assignment operator
+    BPlusTree(BPlusTree<T>&& other) noexcept;               ///< Move constructor
+    BPlusTree<T>& operator=(BPlusTree<T>&& other) noexcept; ///< Move assignment operator
+
+    void insert(const T& value);   ///< Insert a value into the tree
+    void remove(const T& value);   ///< Remove one copy of a value from the tree
+    bool search(const T& value) const;  ///< Search for a value in the tree
+    size_t count() const;          ///< Return the number of values in O(1)
+    T sum() const;                 ///< Return the sum of all values
+    void clear();                  ///< Remove every value from the tree
+
+    template <class Func>
+    bool inOrder(Func func) const;         ///< In-order traversal with any callable
+    template <class Func>
+    bool inOrderCounted(Func func) const;  ///< In-order traversal passing each distinct value and its multiplicity
+
+private:
+    static const int NODE_BYTES = 256;  ///< Target size of the key area of a node (four cache lines)
+    /// Maximum number of keys in a node
+    static const int CAPACITY = (NODE_BYTES / (sizeof(T) + sizeof(size_t)) > 8)
+                                ? static_cast<int>(NODE_BYTES / (sizeof(T) + sizeof(size_t))) : 8;
+    static const int MIN_KEYS = CAPACITY / 2;  ///< Minimum number of keys in a non-root node
+
+    struct NodeBase
+    {
+        bool isLeaf;  ///< Whether the node is a leaf
+        int n;        ///< Number of keys in the node
+    };
+
+    // Arrays have room for one extra key, a node is split as soon as it overflows
+    struct alignas(64) Leaf : NodeBase
+    {
+        T keys[CAPACITY + 1];      ///< Distinct values in ascending order
+        size_t counts[CAPACITY + 1];  ///< Multiplicity of each value
+        Leaf* next;                ///< Next leaf in order
+        Leaf* prev;                ///< Previous leaf in order
+    };
+
+    struct alignas(64) Internal : NodeBase
+    {
+        T keys[CAPACITY + 1];                ///< keys[i] is the smallest value under children[i + 1]
+        NodeBase* children[CAPACITY + 2];    ///< Subtrees
+    };
+
+    NodeBase* m_root;  ///< Root node, nullptr when empty
+    Leaf* m_head;      ///< Leftmost leaf, start of in-order scans
+    size_t m_count;    ///< Number of values, copies included
+
+    static Leaf* newLeaf();
+    static Internal* newInternal();
+    NodeBase* insertRecursive(NodeBase* node, const T& value, T& separator);
+    bool removeRecursive(NodeBase* node, const T& value);
+    void rebalanceChild(Internal* parent, int index);
+    void mergeChildren(Internal* parent, int index);
+    void deleteTree(NodeBase* node);
+    NodeBase* copyTree(const NodeBase* node, Leaf*& lastLeaf);
+};
+
+/**
+ * @brief Constructor for the BPlusTree class
+ *
+ * Initializes an empty tree, with no node allocated.
+ */
+template <class T>
+BPlusTree<T>::BPlusTree() : m_root(nullptr), m_head(nullptr), m_count(0) {}
+
+/**
+ * @brief Destructor for the BPlusTree class
+ *
+ * Deletes every node by calling the `clear` function.
+ */
+template <class T>
+BPlusTree<T>::~BPlusTree()
+{
+    clear();
+}
+
+/**
+ * @brief Copy constructor for the BPlusTree class
+ *
+ * Creates a deep copy of another tree.
+ *
+ * @param other The tree to copy from.
+ */
+template <class T>
+BPlusTree<T>::BPlusTree(const BPlusTree<T>& other) : m_root(nullptr), m_head(nullptr), m_count(0)
+{
+    *this = other;
+}
+
+/**
+ * @brief Assignment operator for the BPlusTree class
+ *
+ * Performs a deep copy of another tree, relinking the copied leaves.
+ *
+ * @param other The tree to copy from.
+ * @return A reference to this tree.
+ */
+template <class T>
+BPlusTree<T>& BPlusTree<T>::operator=(const BPlusTree<T>& other)
+{
+    if (this != &other)
+    {
+        clear();
+        Leaf* lastLeaf = nullptr;
+        m_root = copyTree(other.m_root, lastLeaf);
+        m_count = other.m_count;
+        // Walk back from the last leaf copied to find the new head
+        m_head = lastLeaf;
+        while (m_head != nullptr && m_head->prev != nullptr)
+            m_head = m_head->prev;
+    }
+    return *this;
+}
+
+/**
+ * @brief Move constructor for the BPlusTree class
+ *
+ * Takes over the nodes of another tree, leaving it empty.
+ *
+ * @param other The tree to move from.
+ */
+template <class T>
+BPlusTree<T>::BPlusTree(BPlusTree<T>&& other) noexcept
+    : m_root(other.m_root), m_head(other.m_head), m_count(other.m_count)
+{
+    other.m_root = nullptr;
+    other.m_head = nullptr;
+    other.m_count = 0;
+}
+
+/**
+ * @brief Move assignment operator for the BPlusTree class
+ *
+ * Deletes the current nodes and takes over those of another tree, leaving it empty.
+ *
+ * @param other The tree to move from.
+ * @return A reference to this tree.
+ */
+template <class T>
+BPlusTree<T>& BPlusTree<T>::operator=(BPlusTree<T>&& other) noexcept
+{
+    if (this != &other)
+    {
+        clear();
+        std::swap(m_root, other.m_root);
+        std::swap(m_head, other.m_head);
+        std::swap(m_count, other.m_count);
+    }
+    return *this;
+}
+
+/**
+ * @brief Allocate an empty, unlinked leaf
+ *
+ * @return The new leaf.
+ */
+template <class T>
+typename BPlusTree<T>::Leaf* BPlusTree<T>::newLeaf()
+{
+    Leaf* leaf = new Leaf();
+    leaf->isLeaf = true;
+    leaf->n = 0;
+    leaf->next = nullptr;
+    leaf->prev = nullptr;
+    return leaf;
+}
+
+/**
+ * @brief Allocate an empty internal node
+ *
+ * @return The new node.
+ */
+template <class T>
+typename BPlusTree<T>::Internal* BPlusTree<T>::newInternal()
+{
+    Internal* node = new Internal();
+    node->isLeaf = false;
+    node->n = 0;
+    return node;
+}
+
+/**
+ * @brief Insert a value into the tree
+ *
+ * A value already present has its multiplicity increased. If the root splits, the tree grows by
+ * one level.
+ *
+ * @param value The value to insert.
+ */
+template <class T>
+void BPlusTree<T>::insert(const T& value)
+{
+    if (m_root == nullptr)
+    {
+        m_head = newLeaf();
+        m_root = m_head;
+    }
+    T separator;
+    NodeBase* sibling = insertRecursive(m_root, value, separator);
+    if (sibling != nullptr)
+    {
+        // The root was split, grow the tree by one level
+        Internal* root = newInternal();
+        root->n = 1;
+        root->keys[0] = separator;
+        root->children[0] = m_root;
+        root->children[1] = sibling;
+        m_root = root;
+    }
+    m_count++;
+}
+
+/**
+ * @brief Recursive helper function to insert a value
+ *
+ * @param node The root of the subtree.
+ * @param value The value to insert.
+ * @param separator Receives the smallest value of the new sibling if the node was split.
+ * @return The new right sibling if the node was split, nullptr otherwise.
+ */
+template <class T>
+typename BPlusTree<T>::NodeBase* BPlusTree<T>::insertRecursive(NodeBase* node, const T& value, T& separator)
+{
+    if (node->isLeaf)
+    {
+        Leaf* leaf = static_cast<Leaf*>(node);
+        int pos = bplusRank(leaf->keys, leaf->n, value, false);
+        if (pos < leaf->n && !(value < leaf->keys[pos]))
+        {
+            leaf->counts[pos]++;  // Duplicate only adds a copy
+            return nullptr;
+        }
+        for (int i = leaf->n; i > pos; i--)
+        {
+            leaf->keys[i] = leaf->keys[i - 1];
+            leaf->counts[i] = leaf->counts[i - 1];
+        }
+        leaf->keys[pos] = value;
+        leaf->counts[pos] = 1;
+        if (++leaf->n <= CAPACITY)
+            return nullptr;
+
+        // Split the leaf in two halves
+        Leaf* right = newLeaf();
+        int mid = leaf->n / 2;
+        for (int i = mid; i < leaf->n; i++)
+        {
+            right->keys[i - mid] = leaf->keys[i];
+            right->counts[i - mid] = leaf->counts[i];
+        }
+        right->n = leaf->n - mid;
+        leaf->n = mid;
+        right->next = leaf->next;
+        right->prev = leaf;
+        if (leaf->next != nullptr)
+            leaf->next->prev = right;
+        leaf->next = right;
+        separator = right->keys[0];
+        return right;
+    }
+
+    Internal* internal = static_cast<Internal*>(node);
+    int index = bplusRank(internal->keys, internal->n, value, true);
+    T childSeparator;
+    NodeBase* sibling = insertRecursive(internal->children[index], value, childSeparator);
+    if (sibling == nullptr)
+        return nullptr;
+
+    for (int i = internal->n; i > index; i--)
+    {
+        internal->keys[i] = internal->keys[i - 1];
+        internal->children[i + 1] = internal->children[i];
+    }
+    internal->keys[index] = childSeparator;
+    internal->children[index + 1] = sibling;
+    if (++internal->n <= CAPACITY)
+        return nullptr;
+
+    // Split the internal node, the middle key moves up
+    Internal* right = newInternal();
+    int mid = internal->n / 2;
+    separator = internal->keys[mid];
+    for (int i = mid + 1; i < internal->n; i++)
+        right->keys[i - mid - 1] = internal->keys[i];
+    for (int i = mid + 1; i <= internal->n; i++)
+        right->children[i - mid - 1] = internal->children[i];
+    right->n = internal->n - mid - 1;
+    internal->n = mid;
+    return right;
+}
+
+/**
+ * @brief Remove one copy of a value from the tree
+ *
+ * Does nothing if the value is not present. If the root is left with a single child, the tree
+ * shrinks by one level.
+ *
+ * @param value The value to remove.
+ */
+template <class T>
+void BPlusTree<T>::remove(const T& value)
+{
+    if (m_root == nullptr || !removeRecursive(m_root, value))
+        return;  // Value not found
+    m_count--;
+
+    if (m_root->n == 0)
+    {
+        if (m_root->isLeaf)
+        {
+            delete static_cast<Leaf*>(m_root);
+            m_root = nullptr;
+            m_head = nullptr;
+        }
+        else
+        {
+            // Root has a single child left, shrink the tree by one level
+            Internal* old = static_cast<Internal*>(m_root);
+            m_root = old->children[0];
+            delete old;
+        }
+    }
+}
+
+/**
+ * @brief Recursive helper function to remove one copy of a value
+ *
+ * Children left with too few keys are refilled from a sibling or merged with it.
+ *
+ * @param node The root of the subtree.
+ * @param value The value to remove.
+ * @return `true` if the value was found, `false` otherwise.
+ */
+template <class T>
+bool BPlusTree<T>::removeRecursive(NodeBase* node, const T& value)
+{
+    if (node->isLeaf)
+    {
+        Leaf* leaf = static_cast<Leaf*>(node);
+        int pos = bplusRank(leaf->keys, leaf->n, value, false);
+        if (pos == leaf->n || value < leaf->keys[pos])
+            return false;
+        if (--leaf->counts[pos] > 0)
+            return true;  // Other copies remain
+        for (int i = pos + 1; i < leaf->n; i++)
+        {
+            leaf->keys[i - 1] = leaf->keys[i];
+            leaf->counts[i - 1] = leaf->counts[i];
+        }
+        leaf->n--;
+        return true;
+    }
+
+    Internal* internal = static_cast<Internal*>(node);
+    int index = bplusRank(internal->keys, internal->n, value, true);
+    if (!removeRecursive(internal->children[index], value))
+        return false;
+    if (internal->children[index]->n < MIN_KEYS)
+        rebalanceChild(internal, index);
+    return true;
+}
+
+/**
+ * @brief Refill a child that has too few keys
+ *
+ * Borrows a key from a sibling that can spare one, or merges the child with a sibling.
+ *
+ * @param parent The parent node.
+ * @param index The position of the child in the parent.
+ */
+template <class T>
+void BPlusTree<T>::rebalanceChild(Internal* parent, int index)
+{
+    NodeBase* child = parent->children[index];
+    NodeBase* left = (index > 0) ? parent->children[index - 1] : nullptr;
+    NodeBase* right = (index < parent->n) ? parent->children[index + 1] : nullptr;
+
+    if (left != nullptr && left->n > MIN_KEYS)
+    {
+        if (child->isLeaf)
+        {
+            Leaf* to = static_cast<Leaf*>(child);
+            Leaf* from = static_cast<Leaf*>(left);
+            for (int i = to->n; i > 0; i--)
+            {
+                to->keys[i] = to->keys[i - 1];
+                to->counts[i] = to->counts[i - 1];
+            }
+            to->keys[0] = from->keys[from->n - 1];
+            to->counts[0] = from->counts[from->n - 1];
+            parent->keys[index - 1] = to->keys[0];
+        }
+        else
+        {
+            Internal* to = static_cast<Internal*>(child);
+            Internal* from = static_cast<Internal*>(left);
+            for (int i = to->n; i > 0; i--)
+                to->keys[i] = to->keys[i - 1];
+            for (int i = to->n + 1; i > 0; i--)
+                to->children[i] = to->children[i - 1];
+            to->keys[0] = parent->keys[index - 1];
+            to->children[0] = from->children[from->n];
+            parent->keys[index - 1] = from->keys[from->n - 1];
+        }
+        left->n--;
+        child->n++;
+    }
+    else if (right != nullptr && right->n > MIN_KEYS)
+    {
+        if (child->isLeaf)
+        {
+            Leaf* to = static_cast<Leaf*>(child);
+            Leaf* from = static_cast<Leaf*>(right);
+            to->keys[to->n] = from->keys[0];
+            to->counts[to->n] = from->counts[0];
+            for (int i = 1; i < from->n; i++)
+            {
+                from->keys[i - 1] = from->keys[i];
+                from->counts[i - 1] = from->counts[i];
+            }
+            parent->keys[index] = from->keys[0];
+        }
+        else
+        {
+            Internal* to = static_cast<Internal*>(child);
+            Internal* from = static_cast<Internal*>(right);
+            to->keys[to->n] = parent->keys[index];
+            to->children[to->n + 1] = from->children[0];
+            parent->keys[index] = from->keys[0];
+            for (int i = 1; i < from->n; i++)
+                from->keys[i - 1] = from->keys[i];
+            for (int i = 1; i <= from->n; i++)
+                from->children[i - 1] = from->children[i];
+        }
+        right->n--;
+        child->n++;
+    }
+    else if (left != nullptr)
+    {
+        mergeChildren(parent, index - 1);
+    }
+    else if (right != nullptr)
+    {
+        mergeChildren(parent, index);
+    }
+}
+
+/**
+ * @brief Merge a child with its right sibling
+ *
+ * @param parent The parent node.
+ * @param index The position of the left child of the pair in the parent.
+ */
+template <class T>
+void BPlusTree<T>::mergeChildren(Internal* parent, int index)
+{
+    NodeBase* leftNode = parent->children[index];
+    NodeBase* rightNode = parent->children[index + 1];
+
+    if (leftNode->isLeaf)
+    {
+        Leaf* left = static_cast<Leaf*>(leftNode);
+        Leaf* right = static_cast<Leaf*>(rightNode);
+        for (int i = 0; i < right->n; i++)
+        {
+            left->keys[left->n + i] = right->keys[i];
+            left->counts[left->n + i] = right->counts[i];
+        }
+        left->n += right->n;
+        left->next = right->next;
+        if (right->next != nullptr)
+            right->next->prev = left;
+        delete right;
+    }
+    else
+    {
+        Internal* left = static_cast<Internal*>(leftNode);
+        Internal* right = static_cast<Internal*>(rightNode);
+        left->keys[left->n] = parent->keys[index];  // Separator moves down
+        for (int i = 0; i < right->n; i++)
+            left->keys[left->n + 1 + i] = right->keys[i];
+        for (int i = 0; i <= right->n; i++)
+            left->children[left->n + 1 + i] = right->children[i];
+        left->n += right->n + 1;
+        delete right;
+    }
+
+    for (int i = index + 1; i < parent->n; i++)
+    {
+        parent->keys[i - 1] = parent->keys[i];
+        parent->children[i] = parent->children[i + 1];
+    }
+    parent->n--;
+}
+
+/**
+ * @brief Search for a value in the tree
+ *
+ * Descends one node per level, locating the value in each node with `bplusRank`.
+ *
+ * @param value The value to search for.
+ * @return `true` if the value is in the tree, `false` otherwise.
+ */
+template <class T>
+bool BPlusTree<T>::search(const T& value) const
+{
+    const NodeBase* node = m_root;
+    if (node == nullptr)
+        return false;
+    while (!node->isLeaf)
+    {
+        const Internal* internal = static_cast<const Internal*>(node);
+        node = internal->children[bplusRank(internal->keys, internal->n, value, true)];
+    }
+    const Leaf* leaf = static_cast<const Leaf*>(node);
+    int pos = bplusRank(leaf->keys, leaf->n, value, false);
+    return pos < leaf->n && !(value < leaf->keys[pos]);
+}
+
+/**
+ * @brief Return the number of values in the tree
+ *
+ * Each copy of a value is counted. The count is maintained by `insert` and `remove`, so this is O(1).
+ *
+ * @return The number of values.
+ */
+template <class T>
+size_t BPlusTree<T>::count() const
+{
+    return m_count;
+}
+
+/**
+ * @brief Return the sum of all values in the tree
+ *
+ * Scans the linked leaves, weighting each distinct value by its multiplicity.
+ *
+ * @return The sum of the values.
+ */
+template <class T>
+T BPlusTree<T>::sum() const
+{
+    T total = T();
+    for (const Leaf* leaf = m_head; leaf != nullptr; leaf = leaf->next)
+    {
+        for (int i = 0; i < leaf->n; i++)
+            total += leaf->keys[i] * static_cast<T>(leaf->counts[i]);
+    }
+    return total;
+}
+
+/**
+ * @brief Remove every value from the tree
+ *
+ * Deletes every node and leaves the tree empty.
+ */
+template <class T>
+void BPlusTree<T>::clear()
+{
+    deleteTree(m_root);
+    m_root = nullptr;
+    m_head = nullptr;
+    m_count = 0;
+}
+
+/**
+ * @brief In-order traversal of the tree
+ *
+ * Scans the linked leaves, calling the callable once per copy of each value.
+ *
+ * @param func The callable to apply; returning `false` stops the traversal.
+ * @return `false` if the traversal was stopped early, `true` otherwise.
+ */
+template <class T>
+template <class Func>
+bool BPlusTree<T>::inOrder(Func func) const
+{
+    for (const Leaf* leaf = m_head; leaf != nullptr; leaf = leaf->next)
+    {
+        for (int i = 0; i < leaf->n; i++)
+        {
+            for (size_t copy = 0; copy < leaf->counts[i]; copy++)
+            {
+                if (!bstVisit(func, leaf->keys[i]))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief In-order traversal passing each distinct value and its multiplicity
+ *
+ * Scans the linked leaves, calling the callable once per distinct value.
+ *
+ * @param func The callable to apply to a value and its count; returning `false` stops the traversal.
+ * @return `false` if the traversal was stopped early, `true` otherwise.
+ */
+template <class T>
+template <class Func>
+bool BPlusTree<T>::inOrderCounted(Func func) const
+{
+    for (const Leaf* leaf = m_head; leaf != nullptr; leaf = leaf->next)
+    {
+        for (int i = 0; i < leaf->n; i++)
+        {
+            if (!bstVisit(func, leaf->keys[i], leaf->counts[i]))
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Delete a subtree recursively
+ *
+ * @param node The root of the subtree to delete.
+ */
+template <class T>
+void BPlusTree<T>::deleteTree(NodeBase* node)
+{
+    if (node == nullptr)
+        return;
+    if (node->isLeaf)
+    {
+        delete static_cast<Leaf*>(node);
+        return;
+    }
+    Internal* internal = static_cast<Internal*>(node);
+    for (int i = 0; i <= internal->n; i++)
+        deleteTree(internal->children[i]);
+    delete internal;
+}
+
+/**
+ * @brief Copy a subtree recursively, relinking the copied leaves in order
+ *
+ * @param node The subtree to copy.
+ * @param lastLeaf The last leaf copied so far, updated as leaves are copied.
+ * @return The copy of the subtree.
+ */
+template <class T>
+typename BPlusTree<T>::NodeBase* BPlusTree<T>::copyTree(const NodeBase* node, Leaf*& lastLeaf)
+{
+    if (node == nullptr)
+        return nullptr;
+    if (node->isLeaf)
+    {
+        const Leaf* source = static_cast<const Leaf*>(node);
+        Leaf* leaf = newLeaf();
+        leaf->n = source->n;
+        for (int i = 0; i < source->n; i++)
+        {
+            leaf->keys[i] = source->keys[i];
+            leaf->counts[i] = source->counts[i];
+        }
+        leaf->prev = lastLeaf;
+        if (lastLeaf != nullptr)
+            lastLeaf->next = leaf;
+        lastLeaf = leaf;
+        return leaf;
+    }
+    const Internal* source = static_cast<const Internal*>(node);
+    Internal* internal = newInternal();
+    internal->n = source->n;
+    for (int i = 0; i < source->n; i++)
+        internal->keys[i] = source->keys[i];
+    for (int i = 0; i <= source->n; i++)
+        internal->children[i] = copyTree(source->children[i], lastLeaf);
+    return internal;
+}
+
+#endif // BPLUSTREE_H_INCLUDED
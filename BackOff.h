@@ -0,0 +1,22 @@
+#ifndef BACKOFF_H_INCLUDED
+#define BACKOFF_H_INCLUDED
+
+#include <chrono>
+#include <thread>
+
+/**
+ * @brief Waits a little before a thread checks again for work from another thread
+ *
+ * Short waits spin, long ones sleep so a waiting thread does not keep a core busy.
+ *
+ * @param attempts Number of checks made so far, incremented; reset it to 0 once the wait ends.
+ */
+inline void backOff(unsigned& attempts)
+{
+    if (attempts++ < 64)
+        std::this_thread::yield();
+    else
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+#endif // BACKOFF_H_INCLUDED
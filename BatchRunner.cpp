@@ -0,0 +1,281 @@
+#include "BatchRunner.h"
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    /// Parses a whole token as an integer
+    bool parseNumber(const string& token, int& value)
+    {
+        const char* end = token.data() + token.size();
+        std::from_chars_result result = std::from_chars(token.data(), end, value);
+        return result.ec == std::errc() && result.ptr == end;
+    }
+}
+
+BatchRunner::BatchRunner(Weather& weather)
+    : m_weather(weather), m_reportsAllowed(true)
+{
+}
+
+void BatchRunner::addQuery(const string& query)
+{
+    m_queries.push_back(query);
+}
+
+bool BatchRunner::addQueryFile(const string& filename)
+{
+    ifstream file;
+    if (filename != "-")
+    {
+        file.open(filename);
+        if (!file)
+            return false;
+    }
+    std::istream& in = filename == "-" ? std::cin : file;
+
+    string line;
+    while (getline(in, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        size_t start = line.find_first_not_of(" \t");
+        if (start == string::npos || line[start] == '#')
+            continue;
+        m_queries.push_back(line.substr(start));
+    }
+    return true;
+}
+
+size_t BatchRunner::size() const
+{
+    return m_queries.size();
+}
+
+void BatchRunner::setReportsAllowed(bool allowed)
+{
+    m_reportsAllowed = allowed;
+}
+
+size_t BatchRunner::run(ReportWriter& out)
+{
+    size_t failed = 0;
+    for (size_t i = 0; i < m_queries.size(); i++)
+    {
+        if (!answer(m_queries[i], out))
+            failed++;
+    }
+    if (!out.flush())
+        return m_queries.size();  // Answers were lost, none can be trusted to have arrived
+    return failed;
+}
+
+bool BatchRunner::answer(const string& query, ReportWriter& out) const
+{
+    out << "{\"query\":";
+    writeJsonString(out, query);
+
+    QueryResult result;
+    string error;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool ok;
+    try
+    {
+        ok = runQuery(query, result, error);
+    } catch (const std::exception& exception)
+    {
+        // E.g. a malformed number in a file read by scan; every query still gets its line
+        ok = false;
+        error = string("query failed: ") + exception.what();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (ok)
+    {
+        out << ",\"ok\":true,\"micros\":" << elapsed.count();
+        writeResult(out, result);
+    } else
+    {
+        out << ",\"ok\":false,\"error\":";
+        writeJsonString(out, error);
+    }
+    out << "}\n";
+    return ok;
+}
+
+bool BatchRunner::runQuery(const string& query, QueryResult& result, string& error) const
+{
+    std::istringstream words(query);
+    string& name = result.name;
+    words >> name;
+    std::vector<string> tokens;
+    string word;
+    while (words >> word)
+        tokens.push_back(word);
+    if (name == "scan" && !tokens.empty())
+    {
+        result.file = tokens.back(); // The file ends the query
+        tokens.pop_back();
+    }
+
+    std::vector<int> numbers;
+    for (const string& word : tokens)
+    {
+        int number;
+        if (!parseNumber(word, number))
+        {
+            error = "not a number: " + word;
+            return false;
+        }
+        numbers.push_back(number);
+    }
+
+    size_t expected = (name == "wind" || name == "scan") ? 2 : 1;
+    bool known = name == "wind" || name == "scan" || name == "temp" || name == "solar" || name == "spcc"
+                 || name == "report";
+    if (!known)
+    {
+        error = "unknown query: " + name;
+        return false;
+    }
+    if (numbers.size() != expected)
+    {
+        error = name + " takes " + to_string(expected) + (expected == 1 ? " number" : " numbers")
+                + (name == "scan" ? " and a file" : "");
+        return false;
+    }
+    if ((name == "wind" || name == "scan" || name == "spcc") && (numbers[0] < 1 || numbers[0] > 12))
+    {
+        error = "month must be between 1 and 12";
+        return false;
+    }
+
+    if (name == "report")
+    {
+        if (!m_reportsAllowed)
+        {
+            error = "report is disabled here";
+            return false;
+        }
+        result.file = "WindTempSolar_" + to_string(numbers[0]) + ".csv";
+        if (!m_weather.writeWindTempSolarFile(result.file, numbers[0]))
+        {
+            error = "could not write " + result.file;
+            return false;
+        }
+    } else if (name == "scan")
+    {
+        std::ostringstream log;
+        if (!m_weather.fileWindStats(result.file, numbers[0], numbers[1], result.wind, log))
+        {
+            error = "could not read " + result.file;
+            return false;
+        }
+    } else if (name == "wind")
+        result.wind = m_weather.windStats(numbers[0], numbers[1]);
+    else if (name == "temp")
+        result.temperature = m_weather.temperatureStats(numbers[0]);
+    else if (name == "solar")
+        result.solar = m_weather.solarRadiationStats(numbers[0]);
+    else
+        result.correlation = m_weather.correlation(numbers[0]);
+    return true;
+}
+
+void BatchRunner::writeResult(ReportWriter& out, const QueryResult& result)
+{
+    if (result.name == "report")
+    {
+        out << ",\"file\":";
+        writeJsonString(out, result.file);
+        return;
+    }
+
+    out << ",\"result\":";
+    if (result.name == "wind" || result.name == "scan")
+    {
+        out << '{';
+        writeMonthStats(out, result.wind);
+        out << '}';
+    } else if (result.name == "temp")
+    {
+        for (int month = 1; month <= 12; month++)
+        {
+            out << (month == 1 ? "[{\"month\":" : ",{\"month\":") << month << ',';
+            writeMonthStats(out, result.temperature[month - 1]);
+            out << '}';
+        }
+        out << ']';
+    } else if (result.name == "solar")
+    {
+        for (int month = 1; month <= 12; month++)
+        {
+            const SolarStats& stats = result.solar[month - 1];
+            out << (month == 1 ? "[{\"month\":" : ",{\"month\":") << month << ",\"count\":" << stats.count
+                << ",\"measured\":" << stats.measured << ",\"total\":";
+            writeNumber(out, stats.total);
+            out << '}';
+        }
+        out << ']';
+    } else
+    {
+        out << "{\"count\":" << result.correlation.count << ",\"wind_temperature\":";
+        writeNumber(out, result.correlation.windTemperature);
+        out << ",\"wind_solar\":";
+        writeNumber(out, result.correlation.windSolar);
+        out << ",\"temperature_solar\":";
+        writeNumber(out, result.correlation.temperatureSolar);
+        out << '}';
+    }
+}
+
+void BatchRunner::writeMonthStats(ReportWriter& out, const MonthStats& stats)
+{
+    // Without braces, so the fields can follow others in the same object
+    out << "\"count\":" << stats.count << ",\"mean\":";
+    writeNumber(out, stats.mean);
+    out << ",\"stdev\":";
+    writeNumber(out, stats.stdev);
+    out << ",\"mad\":";
+    writeNumber(out, stats.mad);
+}
+
+void BatchRunner::writeNumber(ReportWriter& out, double value)
+{
+    if (!std::isfinite(value))
+    {
+        out << "null";  // JSON has no infinity or NaN
+        return;
+    }
+    char text[32];
+    std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);  // Shortest exact form
+    *result.ptr = '\0';
+    out << text;
+}
+
+void BatchRunner::writeJsonString(ReportWriter& out, const string& text)
+{
+    static const char hex[] = "0123456789abcdef";
+    out << '"';
+    for (char c : text)
+    {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (c == '\n')
+            out << "\\n";
+        else if (c == '\r')
+            out << "\\r";
+        else if (c == '\t')
+            out << "\\t";
+        else if (byte < 0x20)
+            out << "\\u00" << hex[byte >> 4] << hex[byte & 0xF];
+        else
+            out << c;
+    }
+    out << '"';
+}
@@ -0,0 +1,120 @@
+#ifndef BATCHRUNNER_H_INCLUDED
+#define BATCHRUNNER_H_INCLUDED
+
+#include "weather.h"
+#include <string>
+#include <vector>
+
+using std::string;
+
+/**
+ * @class BatchRunner
+ * @brief Runs a list of queries against loaded weather data without user interaction
+ *
+ * Each query is one line of text, a name followed by its numbers:
+ *
+ * - `wind <month> <year>`: wind speed statistics of a month
+ * - `scan <month> <year> <file>`: wind speed statistics of a month read straight from a data
+ *   file, without the loaded data (see `Weather::fileWindStats`)
+ * - `temp <year>`: temperature statistics of every month of a year
+ * - `solar <year>`: total solar radiation of every month of a year
+ * - `spcc <month>`: correlation coefficients of a month over all years
+ * - `report <year>`: writes the report of a year to `WindTempSolar_<year>.csv`, unless reports
+ *   are disabled (see `setReportsAllowed`)
+ *
+ * Every query produces one line of JSON with the query, whether it succeeded, the time it
+ * took in microseconds, and its result or the reason it failed, e.g.
+ * `{"query":"wind 3 2015","ok":true,"micros":812.5,"result":{"count":4464,"mean":17.87,...}}`.
+ * A result holds the fields of `MonthStats`, an array of twelve months of `MonthStats` or
+ * `SolarStats`, or the fields of `CorrelationResult`, with numbers at full precision. A report
+ * gives the name of its `file` instead. Statistics queries go through the result cache of
+ * `Weather`, so repeated queries are cheap.
+ */
+class BatchRunner
+{
+public:
+    /**
+     * @brief Creates a runner with no queries
+     *
+     * @param weather The loaded weather data to query.
+     */
+    explicit BatchRunner(Weather& weather);
+
+    /**
+     * @brief Adds one query
+     *
+     * @param query The text of the query, e.g. `wind 3 2015`.
+     */
+    void addQuery(const string& query);
+
+    /**
+     * @brief Adds every query of a file, one per line
+     *
+     * Empty lines and lines starting with `#` are skipped.
+     *
+     * @param filename The name of the file, or `-` for the standard input.
+     * @return `true` if the file could be read.
+     */
+    bool addQueryFile(const string& filename);
+
+    /**
+     * @brief Gets the number of queries added
+     *
+     * @return The number of queries.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Allows or refuses `report` queries
+     *
+     * Reports are allowed by default. A refused report is answered as failed without writing
+     * anything, e.g. for clients that should not create files where the program runs.
+     *
+     * @param allowed Whether `report` queries write their file.
+     */
+    void setReportsAllowed(bool allowed);
+
+    /**
+     * @brief Runs every query in order, writing one JSON line per query
+     *
+     * @param out The writer receiving the results.
+     * @return The number of queries that failed, all of them if the results could not be written.
+     */
+    size_t run(ReportWriter& out);
+
+    /**
+     * @brief Runs one query, writing its JSON line
+     *
+     * Several threads may answer queries at once, as long as no data is loaded meanwhile. A query
+     * that throws, e.g. on a malformed number in a file read by `scan`, is answered as failed.
+     *
+     * @param query The text of the query, e.g. `wind 3 2015`.
+     * @param out The writer receiving the line.
+     * @return `true` if the query succeeded.
+     */
+    bool answer(const string& query, ReportWriter& out) const;
+
+private:
+    Weather& m_weather;            ///< Data the queries run against
+    std::vector<string> m_queries; ///< Queries to run, in order
+    bool m_reportsAllowed;         ///< Whether `report` queries write their file
+
+    /// Result of one query, only the member matching its name is set
+    struct QueryResult
+    {
+        string name;                             ///< Name of the query
+        MonthStats wind;                         ///< Result of `wind` and `scan`
+        std::array<MonthStats, 12> temperature;  ///< Result of `temp`
+        std::array<SolarStats, 12> solar;        ///< Result of `solar`
+        CorrelationResult correlation;           ///< Result of `spcc`
+        string file;                             ///< File written by `report`, or read by `scan`
+    };
+
+    bool runQuery(const string& query, QueryResult& result, string& error) const;
+    static void writeResult(ReportWriter& out, const QueryResult& result);
+    static void writeMonthStats(ReportWriter& out, const MonthStats& stats);
+    static void writeNumber(ReportWriter& out, double value);
+    static void writeJsonString(ReportWriter& out, const string& text);
+};
+
+#endif // BATCHRUNNER_H_INCLUDED
@@ -2,14 +2,21 @@
 #define BST_H_INCLUDED
 
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <iterator>
+#include <cstddef>
+#include <type_traits>
+#include "NodeAllocator.h"
 
 /**
  * @class Node
  * @brief Templated node class for Binary Search Tree
  *
- * This class represents a node in a Binary Search Tree. It stores the data and
- * has pointers to its left and right children. It is used as the building block
- * for the `Bst` class.
+ * This class represents a node in a Binary Search Tree. It stores the data, the number
+ * of times that value was inserted, and has pointers to its left and right children.
+ * It is used as the building block for the `Bst` class.
  *
  * @tparam T Type of data stored in the node (e.g., int, float).
  */
@@ -20,11 +27,13 @@ public:
     T data;        ///< Data stored in the node
     Node* left;    ///< Pointer to the left child node
     Node* right;   ///< Pointer to the right child node
+    size_t multiplicity;  ///< Number of copies of `data` held by this node
 
     /**
      * @brief Constructor for Node class
      *
-     * Initializes a node with the given value and sets both left and right pointers to nullptr.
+     * Initializes a node holding one copy of the given value and sets both left and right
+     * pointers to nullptr.
      *
      * @param value The data to store in the node.
      */
@@ -33,54 +42,195 @@ public:
         data = value;    ///< Initialize data
         left = nullptr;  ///< Initialize left pointer
         right = nullptr; ///< Initialize right pointer
+        multiplicity = 1; ///< One copy of the value
     }
 };
 
+/**
+ * @brief Apply a traversal callback to a value
+ *
+ * Callbacks passed to the `Bst` traversals may either return nothing or return a value
+ * convertible to `bool`. A callback returning `false` asks the traversal to stop early.
+ *
+ * @param func The callable to apply.
+ * @param args The arguments to pass to the callable (e.g. a value and its multiplicity).
+ * @return `false` if the callable requested early termination, `true` otherwise.
+ */
+template <class Func, class... Args>
+inline bool bstVisit(std::true_type, Func& func, const Args&... args)
+{
+    func(args...);  ///< Callable returns void, never stops the traversal
+    return true;
+}
+
+template <class Func, class... Args>
+inline bool bstVisit(std::false_type, Func& func, const Args&... args)
+{
+    return static_cast<bool>(func(args...));  ///< Callable decides whether to continue
+}
+
+template <class Func, class... Args>
+inline bool bstVisit(Func& func, const Args&... args)
+{
+    return bstVisit(std::is_void<decltype(func(args...))>(), func, args...);
+}
+
 /**
  * @class Bst
  * @brief Templated Binary Search Tree (BST) class
  *
  * This class implements a Binary Search Tree, which supports common operations such as insertion,
- * deletion, searching, and various tree traversals. It uses recursion for most of its operations.
+ * deletion, searching, and various tree traversals. It uses recursion for most of its operations,
+ * while the traversals and iterators walk the tree iteratively with an explicit stack so they
+ * can accept any callable, stop early, and be used in range-based for loops.
+ *
+ * The tree is a multiset: inserting a value that is already present only increments the
+ * multiplicity of its node, so heavily quantized data (e.g. sensor readings) needs one node
+ * per distinct value. `count`, `sum`, the traversals and the iterators all account for the
+ * multiplicity, and `remove` takes away one copy at a time.
+ *
+ * Nodes are obtained from an allocation policy. The default `PoolAllocator` packs nodes into
+ * contiguous slabs and, for trivially destructible data, frees the whole tree at once instead
+ * of deleting it node by node. `HeapAllocator` gives one heap allocation per node.
  *
  * @tparam T The type of the data stored in the tree nodes (e.g., int, float).
+ * @tparam Alloc The node allocation policy (e.g., `PoolAllocator`, `HeapAllocator`).
  */
-template <class T>
+template <class T, template <class> class Alloc = PoolAllocator>
 class Bst
 {
 private:
     Node<T>* root;  ///< Root node of the tree
+    Alloc<Node<T> > allocator;  ///< Allocation policy owning the nodes
 
     // Helper functions for recursive tree operations
     Node<T>* insertRecursive(Node<T>* node, T value);
     Node<T>* deleteRecursive(Node<T>* node, T value);
     Node<T>* searchRecursive(Node<T>* node, T value);
-    int countNodesRecursive(Node<T>* node) const;
+    size_t countNodesRecursive(Node<T>* node) const;
     T sumNodesRecursive(Node<T>* node) const;
-    void inOrderRecursive(Node<T>* node, void (*func)(T)) const;
-    void preOrderRecursive(Node<T>* node, void (*func)(T)) const;
-    void postOrderRecursive(Node<T>* node, void (*func)(T)) const;
     Node<T>* findMin(Node<T>* node);
     void deleteTree(Node<T>* node);
     Node<T>* copyTree(Node<T>* node);
+    Node<T>* buildBalanced(const std::vector<T>& values, const std::vector<size_t>& runs,
+                           size_t low, size_t high);
 
 public:
+    class Iterator;                 ///< Forward in-order iterator
+    typedef Iterator iterator;      ///< STL-style iterator name
+    typedef Iterator const_iterator; ///< The tree is only read through iterators
+
     Bst();       ///< Constructor for Bst
     ~Bst();      ///< Destructor for Bst
 
-    Bst(const Bst<T>& other);               ///< Copy constructor
-    Bst<T>& operator=(const Bst<T>& other);  ///< Assignment operator
+    Bst(const Bst<T, Alloc>& other);               ///< Copy constructor
+    Bst<T, Alloc>& operator=(const Bst<T, Alloc>& other);  ///< Assignment operator
+    Bst(Bst<T, Alloc>&& other) noexcept;                   ///< Move constructor
+    Bst<T, Alloc>& operator=(Bst<T, Alloc>&& other) noexcept;  ///< Move assignment operator
 
+    template <class InputIt>
+    Bst(InputIt first, InputIt last);      ///< Build a balanced tree from a range of values
+    template <class InputIt>
+    void build(InputIt first, InputIt last);  ///< Replace the contents with a balanced tree built from a range
+
+    void clear();                          ///< Remove every value from the tree
     void insert(T value);                  ///< Insert a value into the tree
     void remove(T value);                  ///< Remove a value from the tree
     bool search(T value);                  ///< Search for a value in the tree
-    int count() const;                     ///< Return the number of nodes in the tree
+    size_t count() const;                  ///< Return the number of values in the tree
     T sum() const;                         ///< Return the sum of all node values
     Node<T>* getRoot() const;              ///< Get the root node
 
-    void inOrder(void (*func)(T)) const;   ///< In-order tree traversal with function pointer
-    void preOrder(void (*func)(T)) const;  ///< Pre-order tree traversal with function pointer
-    void postOrder(void (*func)(T)) const; ///< Post-order tree traversal with function pointer
+    template <class Func>
+    bool inOrder(Func func) const;         ///< In-order tree traversal with any callable
+    template <class Func>
+    bool preOrder(Func func) const;        ///< Pre-order tree traversal with any callable
+    template <class Func>
+    bool postOrder(Func func) const;       ///< Post-order tree traversal with any callable
+    template <class Func>
+    bool inOrderCounted(Func func) const;  ///< In-order traversal passing each distinct value and its multiplicity
+
+    Iterator begin() const;                ///< Iterator to the smallest value
+    Iterator end() const;                  ///< Past-the-end iterator
+};
+
+/**
+ * @class Bst::Iterator
+ * @brief Forward iterator visiting the values of a `Bst` in ascending order
+ *
+ * The iterator keeps the path of nodes whose values are still to be visited on an explicit
+ * stack, so advancing it costs amortised O(1) and no recursion. A value held several times
+ * is visited once per copy. Values are read-only since changing them would break the ordering
+ * of the tree.
+ */
+template <class T, template <class> class Alloc>
+class Bst<T, Alloc>::Iterator
+{
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    Iterator() : m_copy(0) {}  ///< Past-the-end iterator
+
+    explicit Iterator(Node<T>* node) : m_copy(0)
+    {
+        pushLeft(node);  ///< Descend to the smallest value
+    }
+
+    reference operator*() const
+    {
+        return m_path.back()->data;
+    }
+
+    pointer operator->() const
+    {
+        return &m_path.back()->data;
+    }
+
+    Iterator& operator++()
+    {
+        Node<T>* node = m_path.back();
+        if (++m_copy < node->multiplicity)
+            return *this;       ///< Next copy of the same value
+        m_copy = 0;
+        m_path.pop_back();
+        pushLeft(node->right);  ///< Successor is the leftmost node of the right subtree
+        return *this;
+    }
+
+    Iterator operator++(int)
+    {
+        Iterator previous = *this;
+        ++(*this);
+        return previous;
+    }
+
+    bool operator==(const Iterator& other) const
+    {
+        if (m_path.empty() || other.m_path.empty())
+            return m_path.empty() && other.m_path.empty();
+        return m_path.back() == other.m_path.back() && m_copy == other.m_copy;
+    }
+
+    bool operator!=(const Iterator& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    std::vector<Node<T>*> m_path;  ///< Nodes still to be visited, current node on top
+    size_t m_copy;                 ///< Copy of the current value being visited
+
+    void pushLeft(Node<T>* node)
+    {
+        while (node != nullptr) {
+            m_path.push_back(node);
+            node = node->left;
+        }
+    }
 };
 
 /**
@@ -88,8 +238,8 @@ public:
  *
  * Initializes the BST with a null root.
  */
-template <class T>
-Bst<T>::Bst()
+template <class T, template <class> class Alloc>
+Bst<T, Alloc>::Bst()
 {
     root = nullptr;  ///< Initialize root pointer to nullptr
 }
@@ -97,12 +247,12 @@ Bst<T>::Bst()
 /**
  * @brief Destructor for the Bst class
  *
- * Deletes the entire tree by calling the `deleteTree` helper function.
+ * Deletes the entire tree by calling the `clear` function.
  */
-template <class T>
-Bst<T>::~Bst()
+template <class T, template <class> class Alloc>
+Bst<T, Alloc>::~Bst()
 {
-    deleteTree(root);  ///< Delete the entire tree
+    clear();  ///< Delete the entire tree
 }
 
 /**
@@ -112,8 +262,8 @@ Bst<T>::~Bst()
  *
  * @param other The BST to copy from.
  */
-template <class T>
-Bst<T>::Bst(const Bst<T>& other)
+template <class T, template <class> class Alloc>
+Bst<T, Alloc>::Bst(const Bst<T, Alloc>& other) : allocator()
 {
     if (this != &other) {
         root = copyTree(other.root);  ///< Deep copy the tree
@@ -130,16 +280,143 @@ Bst<T>::Bst(const Bst<T>& other)
  * @param other The BST to assign from.
  * @return A reference to the current object.
  */
-template <class T>
-Bst<T>& Bst<T>::operator=(const Bst<T>& other)
+template <class T, template <class> class Alloc>
+Bst<T, Alloc>& Bst<T, Alloc>::operator=(const Bst<T, Alloc>& other)
 {
     if (this != &other) {
-        deleteTree(root);  ///< Delete current tree
+        clear();  ///< Delete current tree
         root = copyTree(other.root);  ///< Deep copy the tree
     }
     return *this;
 }
 
+/**
+ * @brief Move constructor for the Bst class
+ *
+ * Takes over the nodes of another BST without copying them. The other BST is left empty.
+ *
+ * @param other The BST to move from.
+ */
+template <class T, template <class> class Alloc>
+Bst<T, Alloc>::Bst(Bst<T, Alloc>&& other) noexcept : allocator(std::move(other.allocator))
+{
+    root = other.root;      ///< Take over the nodes
+    other.root = nullptr;   ///< Leave the other tree empty
+}
+
+/**
+ * @brief Move assignment operator for the Bst class
+ *
+ * Deletes the current tree and takes over the nodes of another BST without copying them.
+ * The other BST is left empty.
+ *
+ * @param other The BST to move from.
+ * @return A reference to the current object.
+ */
+template <class T, template <class> class Alloc>
+Bst<T, Alloc>& Bst<T, Alloc>::operator=(Bst<T, Alloc>&& other) noexcept
+{
+    if (this != &other) {
+        clear();  ///< Delete current tree
+        allocator = std::move(other.allocator);
+        root = other.root;
+        other.root = nullptr;
+    }
+    return *this;
+}
+
+/**
+ * @brief Range constructor for the Bst class
+ *
+ * Builds a perfectly balanced BST holding the values in `[first, last)`, see `build`.
+ *
+ * @param first Iterator to the first value.
+ * @param last Iterator past the last value.
+ */
+template <class T, template <class> class Alloc>
+template <class InputIt>
+Bst<T, Alloc>::Bst(InputIt first, InputIt last)
+{
+    root = nullptr;
+    build(first, last);
+}
+
+/**
+ * @brief Replace the contents of the BST with the values of a range
+ *
+ * The values are copied and sorted (the sort is skipped when they are already in order),
+ * then equal values are collapsed into one node each and the tree is built top-down by
+ * taking the middle distinct value as the root of every subtree. The result is perfectly
+ * balanced, and apart from the sort the build is O(n), much cheaper than inserting the
+ * values one by one.
+ *
+ * @param first Iterator to the first value.
+ * @param last Iterator past the last value.
+ */
+template <class T, template <class> class Alloc>
+template <class InputIt>
+void Bst<T, Alloc>::build(InputIt first, InputIt last)
+{
+    std::vector<T> values(first, last);
+    if (!std::is_sorted(values.begin(), values.end()))
+        std::sort(values.begin(), values.end());
+
+    // Start index of every run of equal values, plus the end of the last run
+    std::vector<size_t> runs;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i == 0 || values[i - 1] < values[i])
+            runs.push_back(i);
+    }
+    runs.push_back(values.size());
+
+    clear();  ///< Delete current tree
+    root = buildBalanced(values, runs, 0, runs.size() - 1);
+}
+
+/**
+ * @brief Recursive helper function to build a balanced subtree
+ *
+ * Builds the subtree holding the runs of equal values `[low, high)`, with the middle run as
+ * its root.
+ *
+ * @param values The sorted values.
+ * @param runs The start index of every run of equal values, followed by `values.size()`.
+ * @param low The first run of the subtree.
+ * @param high One past the last run of the subtree.
+ * @return The root of the new subtree.
+ */
+template <class T, template <class> class Alloc>
+Node<T>* Bst<T, Alloc>::buildBalanced(const std::vector<T>& values, const std::vector<size_t>& runs,
+                                      size_t low, size_t high)
+{
+    if (low >= high) {
+        return nullptr;  ///< Empty subtree
+    }
+    size_t mid = low + (high - low) / 2;
+    Node<T>* node = allocator.create(values[runs[mid]]);
+    node->multiplicity = runs[mid + 1] - runs[mid];  ///< Every copy of the value
+    node->left = buildBalanced(values, runs, low, mid);        ///< Smaller values
+    node->right = buildBalanced(values, runs, mid + 1, high);  ///< Larger values
+    return node;
+}
+
+/**
+ * @brief Remove every value from the BST
+ *
+ * When the allocation policy can release all of its nodes at once (e.g. a `PoolAllocator` of
+ * trivially destructible nodes), the memory is returned without visiting the nodes. Otherwise
+ * every node is destroyed by the `deleteTree` helper function.
+ */
+template <class T, template <class> class Alloc>
+void Bst<T, Alloc>::clear()
+{
+    if (!Alloc<Node<T> >::releasesInBulk) {
+        deleteTree(root);  ///< Destroy nodes one by one
+    }
+    allocator.releaseAll();  ///< Return the node memory
+    root = nullptr;
+}
+
 /**
  * @brief Insert a value into the BST
  *
@@ -147,8 +424,8 @@ Bst<T>& Bst<T>::operator=(const Bst<T>& other)
  *
  * @param value The value to insert into the tree.
  */
-template <class T>
-void Bst<T>::insert(T value)
+template <class T, template <class> class Alloc>
+void Bst<T, Alloc>::insert(T value)
 {
     root = insertRecursive(root, value);  ///< Call the recursive insert
 }
@@ -162,19 +439,23 @@ void Bst<T>::insert(T value)
  * @param value The value to insert.
  * @return The updated node (with the inserted value).
  */
-template <class T>
-Node<T>* Bst<T>::insertRecursive(Node<T>* node, T value)
+template <class T, template <class> class Alloc>
+Node<T>* Bst<T, Alloc>::insertRecursive(Node<T>* node, T value)
 {
     if (node == nullptr)
-        return new Node<T>(value);  ///< Create new node if reached empty spot
+        return allocator.create(value);  ///< Create new node if reached empty spot
 
     if (value < node->data)
     {
         node->left = insertRecursive(node->left, value);  ///< Go left if value is smaller
     }
+    else if (value > node->data)
+    {
+        node->right = insertRecursive(node->right, value);  ///< Go right if value is larger
+    }
     else
     {
-        node->right = insertRecursive(node->right, value);  ///< Go right if value is larger or equal
+        node->multiplicity++;  ///< Duplicate only adds a copy to the existing node
     }
     return node;  ///< Return the node (modified or unchanged)
 }
@@ -186,8 +467,8 @@ Node<T>* Bst<T>::insertRecursive(Node<T>* node, T value)
  *
  * @param value The value to remove from the tree.
  */
-template <class T>
-void Bst<T>::remove(T value)
+template <class T, template <class> class Alloc>
+void Bst<T, Alloc>::remove(T value)
 {
     root = deleteRecursive(root, value);  ///< Call the recursive delete
 }
@@ -195,7 +476,8 @@ void Bst<T>::remove(T value)
 /**
  * @brief Recursive helper function to remove a value from the BST
  *
- * This function finds and deletes the specified value from the tree, handling the three cases:
+ * This function finds the specified value and removes one copy of it. When the last copy is
+ * removed, the node is deleted from the tree, handling the three cases:
  * - No children
  * - One child
  * - Two children (find the in-order successor)
@@ -204,8 +486,8 @@ void Bst<T>::remove(T value)
  * @param value The value to remove.
  * @return The updated node (after removal).
  */
-template <class T>
-Node<T>* Bst<T>::deleteRecursive(Node<T>* node, T value)
+template <class T, template <class> class Alloc>
+Node<T>* Bst<T, Alloc>::deleteRecursive(Node<T>* node, T value)
 {
     if (node == nullptr) {
         return nullptr;  ///< Value not found
@@ -219,19 +501,24 @@ Node<T>* Bst<T>::deleteRecursive(Node<T>* node, T value)
     }
     else {
         // Node to be deleted found
-        if (node->left == nullptr) {
+        if (node->multiplicity > 1) {
+            node->multiplicity--;  ///< Other copies remain, keep the node
+        }
+        else if (node->left == nullptr) {
             Node<T>* temp = node->right;
-            delete node;
+            allocator.destroy(node);
             return temp;  ///< Replace with right child
         }
         else if (node->right == nullptr) {
             Node<T>* temp = node->left;
-            delete node;
+            allocator.destroy(node);
             return temp;  ///< Replace with left child
         }
         else {
             Node<T>* temp = findMin(node->right);  ///< Find in-order successor
             node->data = temp->data;
+            node->multiplicity = temp->multiplicity;  ///< Take over every copy of the successor
+            temp->multiplicity = 1;
             node->right = deleteRecursive(node->right, temp->data);  ///< Delete the successor
         }
     }
@@ -246,8 +533,8 @@ Node<T>* Bst<T>::deleteRecursive(Node<T>* node, T value)
  * @param value The value to search for.
  * @return `true` if the value is found, `false` otherwise.
  */
-template <class T>
-bool Bst<T>::search(T value)
+template <class T, template <class> class Alloc>
+bool Bst<T, Alloc>::search(T value)
 {
     return searchRecursive(root, value);
 }
@@ -261,8 +548,8 @@ bool Bst<T>::search(T value)
  * @param value The value to search for.
  * @return The node containing the value, or nullptr if not found.
  */
-template <class T>
-Node<T>* Bst<T>::searchRecursive(Node<T>* node, T value)
+template <class T, template <class> class Alloc>
+Node<T>* Bst<T, Alloc>::searchRecursive(Node<T>* node, T value)
 {
     if (node == nullptr) {
         return nullptr;  ///< Value not found
@@ -279,33 +566,33 @@ Node<T>* Bst<T>::searchRecursive(Node<T>* node, T value)
 }
 
 /**
- * @brief Count the number of nodes in the BST
+ * @brief Count the number of values in the BST
  *
- * Calls the recursive count function to count all nodes in the tree.
+ * Calls the recursive count function to count all values in the tree, duplicates included.
  *
- * @return The total number of nodes in the tree.
+ * @return The total number of values in the tree.
  */
-template <class T>
-int Bst<T>::count() const
+template <class T, template <class> class Alloc>
+size_t Bst<T, Alloc>::count() const
 {
     return countNodesRecursive(root);
 }
 
 /**
- * @brief Recursive helper function to count the nodes in the tree
+ * @brief Recursive helper function to count the values in the tree
  *
- * This function recursively counts all the nodes in the tree.
+ * This function recursively adds up the multiplicity of all the nodes in the tree.
  *
  * @param node The current node being examined.
- * @return The total number of nodes.
+ * @return The total number of values.
  */
-template <class T>
-int Bst<T>::countNodesRecursive(Node<T>* node) const
+template <class T, template <class> class Alloc>
+size_t Bst<T, Alloc>::countNodesRecursive(Node<T>* node) const
 {
     if (node == nullptr) {
         return 0;  ///< Return 0 for nullptr (base case)
     }
-    return 1 + countNodesRecursive(node->left) + countNodesRecursive(node->right);
+    return node->multiplicity + countNodesRecursive(node->left) + countNodesRecursive(node->right);
 }
 
 /**
@@ -315,8 +602,8 @@ int Bst<T>::countNodesRecursive(Node<T>* node) const
  *
  * @return The sum of all node values.
  */
-template <class T>
-T Bst<T>::sum() const
+template <class T, template <class> class Alloc>
+T Bst<T, Alloc>::sum() const
 {
     return sumNodesRecursive(root);
 }
@@ -324,18 +611,19 @@ T Bst<T>::sum() const
 /**
  * @brief Recursive helper function to calculate the sum of all node values
  *
- * This function recursively sums all the values stored in the tree's nodes.
+ * This function recursively sums all the values stored in the tree's nodes, each one
+ * weighted by its multiplicity.
  *
  * @param node The current node being examined.
  * @return The sum of all node values.
  */
-template <class T>
-T Bst<T>::sumNodesRecursive(Node<T>* node) const
+template <class T, template <class> class Alloc>
+T Bst<T, Alloc>::sumNodesRecursive(Node<T>* node) const
 {
     if (node == nullptr) {
         return T();  ///< Return default value (e.g., 0 for numeric types)
     }
-    return node->data + sumNodesRecursive(node->left) + sumNodesRecursive(node->right);
+    return node->data * static_cast<T>(node->multiplicity) + sumNodesRecursive(node->left) + sumNodesRecursive(node->right);
 }
 
 /**
@@ -343,109 +631,164 @@ T Bst<T>::sumNodesRecursive(Node<T>* node) const
  *
  * @return A pointer to the root node.
  */
-template <class T>
-Node<T>* Bst<T>::getRoot() const
+template <class T, template <class> class Alloc>
+Node<T>* Bst<T, Alloc>::getRoot() const
 {
     return root;
 }
 
 /**
- * @brief In-order traversal of the tree with a function pointer
+ * @brief In-order traversal of the tree with any callable
  *
- * This function performs an in-order traversal of the tree and applies a given function
- * to each node's value.
+ * This function performs an iterative in-order traversal of the tree and applies the given
+ * callable to each node's value. The callable may capture state (e.g. a lambda), and may
+ * return `false` to stop the traversal early.
  *
- * @param func The function to apply to each node's value.
+ * @param func The callable to apply to each node's value.
+ * @return `true` if every node was visited, `false` if the callable stopped the traversal.
  */
-template <class T>
-void Bst<T>::inOrder(void (*func)(T)) const
+template <class T, template <class> class Alloc>
+template <class Func>
+bool Bst<T, Alloc>::inOrder(Func func) const
 {
-    inOrderRecursive(root, func);
+    std::vector<Node<T>*> stack;
+    Node<T>* node = root;
+    while (node != nullptr || !stack.empty()) {
+        while (node != nullptr) {
+            stack.push_back(node);  ///< Defer the node until its left subtree is done
+            node = node->left;
+        }
+        node = stack.back();
+        stack.pop_back();
+        for (size_t copy = 0; copy < node->multiplicity; copy++) {
+            if (!bstVisit(func, node->data))
+                return false;       ///< Callable asked to stop
+        }
+        node = node->right;         ///< Visit right subtree
+    }
+    return true;
 }
 
 /**
- * @brief Recursive in-order helper function
+ * @brief In-order traversal visiting each distinct value once with its multiplicity
  *
- * This function recursively traverses the tree in in-order fashion and applies
- * the given function to each node's value.
+ * This function performs the same walk as `inOrder`, but calls the callable once per node
+ * as `func(value, multiplicity)`, which lets aggregates weight a value instead of processing
+ * every copy of it. The callable may return `false` to stop the traversal early.
  *
- * @param node The current node being examined.
- * @param func The function to apply to the node's data.
+ * @param func The callable to apply to each distinct value and its multiplicity.
+ * @return `true` if every node was visited, `false` if the callable stopped the traversal.
  */
-template <class T>
-void Bst<T>::inOrderRecursive(Node<T>* node, void (*func)(T)) const
+template <class T, template <class> class Alloc>
+template <class Func>
+bool Bst<T, Alloc>::inOrderCounted(Func func) const
 {
-    if (node != nullptr) {
-        inOrderRecursive(node->left, func);  ///< Visit left subtree
-        func(node->data);                    ///< Apply function to node data
-        inOrderRecursive(node->right, func); ///< Visit right subtree
+    std::vector<Node<T>*> stack;
+    Node<T>* node = root;
+    while (node != nullptr || !stack.empty()) {
+        while (node != nullptr) {
+            stack.push_back(node);
+            node = node->left;
+        }
+        node = stack.back();
+        stack.pop_back();
+        if (!bstVisit(func, node->data, node->multiplicity))
+            return false;           ///< Callable asked to stop
+        node = node->right;
     }
+    return true;
 }
 
 /**
- * @brief Pre-order traversal of the tree with a function pointer
+ * @brief Pre-order traversal of the tree with any callable
  *
- * This function performs a pre-order traversal of the tree and applies a given function
- * to each node's value.
+ * This function performs an iterative pre-order traversal of the tree and applies the given
+ * callable to each node's value. The callable may return `false` to stop the traversal early.
  *
- * @param func The function to apply to each node's value.
+ * @param func The callable to apply to each node's value.
+ * @return `true` if every node was visited, `false` if the callable stopped the traversal.
  */
-template <class T>
-void Bst<T>::preOrder(void (*func)(T)) const
+template <class T, template <class> class Alloc>
+template <class Func>
+bool Bst<T, Alloc>::preOrder(Func func) const
 {
-    preOrderRecursive(root, func);
+    std::vector<Node<T>*> stack;
+    if (root != nullptr)
+        stack.push_back(root);
+    while (!stack.empty()) {
+        Node<T>* node = stack.back();
+        stack.pop_back();
+        for (size_t copy = 0; copy < node->multiplicity; copy++) {
+            if (!bstVisit(func, node->data))
+                return false;            ///< Callable asked to stop
+        }
+        if (node->right != nullptr)
+            stack.push_back(node->right);  ///< Right subtree is visited after the left one
+        if (node->left != nullptr)
+            stack.push_back(node->left);
+    }
+    return true;
 }
 
 /**
- * @brief Recursive pre-order helper function
+ * @brief Post-order traversal of the tree with any callable
  *
- * This function recursively traverses the tree in pre-order fashion and applies
- * the given function to each node's value.
+ * This function performs an iterative post-order traversal of the tree and applies the given
+ * callable to each node's value. The callable may return `false` to stop the traversal early.
  *
- * @param node The current node being examined.
- * @param func The function to apply to the node's data.
+ * @param func The callable to apply to each node's value.
+ * @return `true` if every node was visited, `false` if the callable stopped the traversal.
  */
-template <class T>
-void Bst<T>::preOrderRecursive(Node<T>* node, void (*func)(T)) const
+template <class T, template <class> class Alloc>
+template <class Func>
+bool Bst<T, Alloc>::postOrder(Func func) const
 {
-    if (node != nullptr) {
-        func(node->data);                    ///< Apply function to node data
-        preOrderRecursive(node->left, func);  ///< Visit left subtree
-        preOrderRecursive(node->right, func); ///< Visit right subtree
+    std::vector<Node<T>*> stack;
+    Node<T>* node = root;
+    Node<T>* lastVisited = nullptr;
+    while (node != nullptr || !stack.empty()) {
+        if (node != nullptr) {
+            stack.push_back(node);  ///< Descend left first
+            node = node->left;
+        }
+        else {
+            Node<T>* top = stack.back();
+            if (top->right != nullptr && top->right != lastVisited) {
+                node = top->right;  ///< Right subtree not visited yet
+            }
+            else {
+                for (size_t copy = 0; copy < top->multiplicity; copy++) {
+                    if (!bstVisit(func, top->data))
+                        return false;  ///< Callable asked to stop
+                }
+                lastVisited = top;
+                stack.pop_back();
+            }
+        }
     }
+    return true;
 }
 
 /**
- * @brief Post-order traversal of the tree with a function pointer
- *
- * This function performs a post-order traversal of the tree and applies a given function
- * to each node's value.
+ * @brief Get an iterator to the smallest value in the BST
  *
- * @param func The function to apply to each node's value.
+ * @return An in-order iterator positioned on the smallest value, or `end()` if the tree is empty.
  */
-template <class T>
-void Bst<T>::postOrder(void (*func)(T)) const
+template <class T, template <class> class Alloc>
+typename Bst<T, Alloc>::Iterator Bst<T, Alloc>::begin() const
 {
-    postOrderRecursive(root, func);
+    return Iterator(root);
 }
 
 /**
- * @brief Recursive post-order helper function
- *
- * This function recursively traverses the tree in post-order fashion and applies
- * the given function to each node's value.
+ * @brief Get the past-the-end iterator of the BST
  *
- * @param node The current node being examined.
- * @param func The function to apply to the node's data.
+ * @return An iterator that compares equal to any iterator that has visited every value.
  */
-template <class T>
-void Bst<T>::postOrderRecursive(Node<T>* node, void (*func)(T)) const
+template <class T, template <class> class Alloc>
+typename Bst<T, Alloc>::Iterator Bst<T, Alloc>::end() const
 {
-    if (node != nullptr) {
-        postOrderRecursive(node->left, func);  ///< Visit left subtree
-        postOrderRecursive(node->right, func); ///< Visit right subtree
-        func(node->data);                      ///< Apply function to node data
-    }
+    return Iterator();
 }
 
 /**
@@ -457,8 +800,8 @@ void Bst<T>::postOrderRecursive(Node<T>* node, void (*func)(T)) const
  * @param node The current node being examined.
  * @return A pointer to the minimum node in the subtree.
  */
-template <class T>
-Node<T>* Bst<T>::findMin(Node<T>* node)
+template <class T, template <class> class Alloc>
+Node<T>* Bst<T, Alloc>::findMin(Node<T>* node)
 {
     while (node && node->left != nullptr)
         node = node->left;  ///< Move to the leftmost node
@@ -472,13 +815,13 @@ Node<T>* Bst<T>::findMin(Node<T>* node)
  *
  * @param node The current node being deleted.
  */
-template <class T>
-void Bst<T>::deleteTree(Node<T>* node)
+template <class T, template <class> class Alloc>
+void Bst<T, Alloc>::deleteTree(Node<T>* node)
 {
     if (node != nullptr) {
         deleteTree(node->left);   ///< Delete left subtree
         deleteTree(node->right);  ///< Delete right subtree
-        delete node;              ///< Delete the current node
+        allocator.destroy(node);  ///< Delete the current node
     }
 }
 
@@ -490,13 +833,14 @@ void Bst<T>::deleteTree(Node<T>* node)
  * @param node The current node being copied.
  * @return A pointer to the new node that is a copy of the given node.
  */
-template <class T>
-Node<T>* Bst<T>::copyTree(Node<T>* node)
+template <class T, template <class> class Alloc>
+Node<T>* Bst<T, Alloc>::copyTree(Node<T>* node)
 {
     if (node == nullptr) {
         return nullptr;  ///< Return nullptr for empty node
     }
-    Node<T>* newNode = new Node<T>(node->data);  ///< Create a new node
+    Node<T>* newNode = allocator.create(node->data);  ///< Create a new node
+    newNode->multiplicity = node->multiplicity;      ///< Keep every copy of the value
     newNode->left = copyTree(node->left);        ///< Copy left subtree
     newNode->right = copyTree(node->right);      ///< Copy right subtree
     return newNode;                              ///< Return the new node
@@ -0,0 +1,147 @@
+#ifndef CALENDAR_H_INCLUDED
+#define CALENDAR_H_INCLUDED
+
+/**
+ * @class Calendar
+ * @brief Compile-time tables and functions for the Gregorian calendar
+ *
+ * Fixed lookups such as month names and month lengths are constexpr tables indexed directly
+ * by the month number, so they cost one load from static data and never allocate, and can be
+ * evaluated at compile time.
+ *
+ * Dates convert to and from a serial day number, the number of days since 1 January 1970
+ * (negative before it), with the days-from-civil algorithms of Howard Hinnant. The conversions
+ * are a handful of integer operations with no loops and no table lookups, valid for proleptic
+ * Gregorian dates from `MIN_YEAR` to `MAX_YEAR`. Further out, around year 5.8 million either
+ * way, the serial number no longer fits in an `int`. Once dates are serial numbers, intervals
+ * are a subtraction, adding days is an addition and the weekday is a remainder.
+ */
+class Calendar
+{
+public:
+    static constexpr int MIN_YEAR = -5000000;  ///< Earliest year the serial day conversions support
+    static constexpr int MAX_YEAR = 5000000;   ///< Latest year the serial day conversions support
+
+    /// Full month names, index 0 is returned for any month outside 1-12
+    static constexpr const char* MONTH_NAMES[13] = {
+        "Invalid Month", "January", "February", "March", "April", "May", "June",
+        "July", "August", "September", "October", "November", "December"
+    };
+
+    /// Number of days in each month of a common year, index 0 unused
+    static constexpr int DAYS_IN_MONTH[13] = { 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    /// Number of days before the first of each month in a common year, index 0 unused
+    static constexpr int DAYS_BEFORE_MONTH[13] = { 0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+
+    /**
+     * @struct Civil
+     * @brief A calendar date split into fields
+     */
+    struct Civil
+    {
+        int year;   ///< Year (e.g., 2024)
+        int month;  ///< Month of the year (1-12)
+        int day;    ///< Day of the month (1-31)
+    };
+
+    /**
+     * @brief Gets the full name of a month
+     *
+     * @param month The month number (1-12).
+     * @return The full name of the month, or "Invalid Month" if the number is not 1-12.
+     */
+    static constexpr const char* monthName(int month)
+    {
+        return MONTH_NAMES[(month >= 1 && month <= 12) ? month : 0];
+    }
+
+    /**
+     * @brief Checks if a year is a leap year
+     *
+     * @param year The year.
+     * @return `true` if February of that year has 29 days.
+     */
+    static constexpr bool isLeapYear(int year)
+    {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    /**
+     * @brief Gets the number of days in a month
+     *
+     * @param month The month number (1-12).
+     * @param year The year, for February in leap years.
+     * @return The number of days in the month, or 0 if the month is not 1-12.
+     */
+    static constexpr int daysInMonth(int month, int year)
+    {
+        return (month >= 1 && month <= 12) ? DAYS_IN_MONTH[month] + (month == 2 && isLeapYear(year)) : 0;
+    }
+
+    /**
+     * @brief Gets the position of a date in its year
+     *
+     * @param year The year.
+     * @param month The month number (1-12).
+     * @param day The day of the month.
+     * @return The day of the year, 1 for 1 January.
+     * @pre The month number must be between 1 and 12.
+     */
+    static constexpr int dayOfYear(int year, int month, int day)
+    {
+        return DAYS_BEFORE_MONTH[month] + day + (month > 2 && isLeapYear(year));
+    }
+
+    /**
+     * @brief Converts a calendar date to its serial day number
+     *
+     * @param year The year.
+     * @param month The month number (1-12).
+     * @param day The day of the month.
+     * @return The number of days from 1 January 1970 to the date.
+     * @pre The year must be between `MIN_YEAR` and `MAX_YEAR`.
+     */
+    static constexpr int daysFromCivil(int year, int month, int day)
+    {
+        year -= month <= 2;  // Count years from 1 March, so the leap day ends the year
+        const int era = (year >= 0 ? year : year - 399) / 400;
+        const int yearOfEra = year - era * 400;                                     // [0, 399]
+        const int dayOfYearFromMarch = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYearFromMarch;
+        return era * 146097 + dayOfEra - 719468;  // 719468 days from 1 March 0000 to 1 January 1970
+    }
+
+    /**
+     * @brief Converts a serial day number back to a calendar date
+     *
+     * @param days The number of days from 1 January 1970.
+     * @return The calendar date.
+     * @pre The date must fall between `MIN_YEAR` and `MAX_YEAR`.
+     */
+    static constexpr Civil civilFromDays(int days)
+    {
+        days += 719468;
+        const int era = (days >= 0 ? days : days - 146096) / 146097;
+        const int dayOfEra = days - era * 146097;                                                   // [0, 146096]
+        const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;  // [0, 399]
+        const int dayOfYearFromMarch = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const int monthFromMarch = (5 * dayOfYearFromMarch + 2) / 153;                              // [0, 11]
+        const int day = dayOfYearFromMarch - (153 * monthFromMarch + 2) / 5 + 1;
+        const int month = monthFromMarch < 10 ? monthFromMarch + 3 : monthFromMarch - 9;
+        return Civil{ yearOfEra + era * 400 + (month <= 2), month, day };
+    }
+
+    /**
+     * @brief Gets the weekday of a serial day number
+     *
+     * @param days The number of days from 1 January 1970.
+     * @return The day of the week, 0 for Sunday to 6 for Saturday.
+     */
+    static constexpr int dayOfWeek(int days)
+    {
+        return (days >= -4) ? (days + 4) % 7 : (days + 5) % 7 + 6;  // 1 January 1970 was a Thursday
+    }
+};
+
+#endif // CALENDAR_H_INCLUDED
@@ -0,0 +1,135 @@
+#include "ChunkReader.h"
+#include "BackOff.h"
+#include <cstring>
+
+ChunkReader::ChunkReader(const string& filename)
+    : m_file(std::fopen(filename.c_str(), "rb")), m_chunk{CHUNK_COUNT, 0, false}, m_position(nullptr),
+      m_finished(m_file == nullptr), m_failed(m_file == nullptr), m_stop(false)
+{
+    if (m_file == nullptr)
+        return;
+    std::setvbuf(m_file, nullptr, _IONBF, 0);  // Read straight into the buffers, no extra copy
+
+    for (size_t i = 0; i < CHUNK_COUNT; i++)
+    {
+        m_buffers[i].reset(new char[CHUNK_SIZE]);
+        m_free.tryPush(i);
+    }
+    m_reader = std::thread(&ChunkReader::read, this);
+}
+
+ChunkReader::~ChunkReader()
+{
+    m_stop = true;
+    if (m_reader.joinable())
+        m_reader.join();
+    if (m_file != nullptr)
+        std::fclose(m_file);
+}
+
+bool ChunkReader::isOpen() const
+{
+    return m_file != nullptr;
+}
+
+bool ChunkReader::failed() const
+{
+    return m_failed;
+}
+
+bool ChunkReader::nextLine(const char*& line, size_t& length)
+{
+    while (!m_finished)
+    {
+        if (m_position == nullptr)
+        {
+            m_chunk = nextChunk();
+            if (m_chunk.length == 0)
+            {
+                m_finished = true;
+                m_failed = m_chunk.failed;
+                break;
+            }
+            m_position = m_buffers[m_chunk.index].get();
+        }
+
+        const char* end = m_buffers[m_chunk.index].get() + m_chunk.length;
+        const char* newline = static_cast<const char*>(std::memchr(m_position, '\n', end - m_position));
+        if (newline == nullptr)
+        {
+            // The rest of the buffer starts a line, hand the buffer back and continue in the next one
+            m_carry.append(m_position, end);
+            releaseChunk(m_chunk);
+            m_position = nullptr;
+            continue;
+        }
+
+        line = m_position;
+        length = newline - m_position;
+        m_position = newline + 1;
+        if (!m_carry.empty())
+        {
+            m_carry.append(line, length);
+            m_line.swap(m_carry);
+            m_carry.clear();
+            line = m_line.data();
+            length = m_line.size();
+        }
+        if (length > 0 && line[length - 1] == '\r')
+            length--;
+        return true;
+    }
+
+    // The last line may have no line break
+    if (m_failed || m_carry.empty())
+        return false;
+    m_line.swap(m_carry);
+    m_carry.clear();
+    line = m_line.data();
+    length = m_line.size();
+    if (length > 0 && line[length - 1] == '\r')
+        length--;
+    return true;
+}
+
+void ChunkReader::read()
+{
+    unsigned attempts = 0;
+    while (true)
+    {
+        size_t index;
+        while (!m_free.tryPop(index))
+        {
+            if (m_stop)
+                return;
+            backOff(attempts);  // Every buffer is waiting to be handled
+        }
+        attempts = 0;
+
+        Chunk chunk = {index, std::fread(m_buffers[index].get(), 1, CHUNK_SIZE, m_file), false};
+        if (chunk.length == 0)
+            chunk = Chunk{CHUNK_COUNT, 0, std::ferror(m_file) != 0};
+        while (!m_filled.tryPush(chunk))
+        {
+            if (m_stop)
+                return;
+            backOff(attempts);
+        }
+        if (chunk.length == 0)
+            return;
+    }
+}
+
+ChunkReader::Chunk ChunkReader::nextChunk()
+{
+    Chunk chunk;
+    unsigned attempts = 0;
+    while (!m_filled.tryPop(chunk))
+        backOff(attempts);  // The disk is behind
+    return chunk;
+}
+
+void ChunkReader::releaseChunk(const Chunk& chunk)
+{
+    m_free.tryPush(chunk.index);  // Never full, it has room for every buffer
+}
@@ -0,0 +1,99 @@
+#ifndef CHUNKREADER_H_INCLUDED
+#define CHUNKREADER_H_INCLUDED
+
+#include "SpscRing.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+using std::string;
+
+/**
+ * @class ChunkReader
+ * @brief Reads a text file line by line, reading ahead on a separate thread
+ *
+ * A reader thread fills large buffers from the file while the calling thread handles the
+ * lines of the buffers already read, so the disk and the processor work at the same time.
+ * Filled buffers are handed to the caller through one `SpscRing` and returned for refilling
+ * through another, so neither thread takes a lock. A line that straddles two buffers is put
+ * back together before it is handed over. Lines are pulled one at a time with `nextLine`.
+ */
+class ChunkReader
+{
+public:
+    static const size_t CHUNK_SIZE = 1 << 20;  ///< Bytes read at once (1 MiB)
+    static const size_t CHUNK_COUNT = 4;       ///< Buffers in flight between the two threads
+
+    /**
+     * @brief Opens a file and starts reading it ahead
+     *
+     * @param filename The name of the file.
+     */
+    explicit ChunkReader(const string& filename);
+
+    /**
+     * @brief Destructor
+     *
+     * Stops the reader thread, even if the file was not read to the end, and closes the file.
+     */
+    ~ChunkReader();
+
+    ChunkReader(const ChunkReader&) = delete;
+    ChunkReader& operator=(const ChunkReader&) = delete;
+
+    /**
+     * @brief Checks if the file could be opened
+     *
+     * @return `true` if the file is open.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Gets the next line of the file
+     *
+     * Lines are given without their line break, a `\r` before it included.
+     *
+     * @param line Receives the start of the line, valid until the next call.
+     * @param length Receives the number of characters of the line.
+     * @return `true` if a line was read, `false` at the end of the file or on a read error.
+     */
+    bool nextLine(const char*& line, size_t& length);
+
+    /**
+     * @brief Checks if reading the file failed
+     *
+     * @return `true` if the file could not be opened or read.
+     */
+    bool failed() const;
+
+private:
+    /// Buffer handed from the reader thread to the caller
+    struct Chunk
+    {
+        size_t index;   ///< Buffer holding the bytes, `CHUNK_COUNT` for the end of the file
+        size_t length;  ///< Number of bytes read, 0 at the end of the file
+        bool failed;    ///< Whether the end was caused by a read error
+    };
+
+    FILE* m_file;                                   ///< File being read
+    std::unique_ptr<char[]> m_buffers[CHUNK_COUNT]; ///< Buffers the file is read into, left uninitialized
+    SpscRing<Chunk, CHUNK_COUNT> m_filled;          ///< Filled buffers, from the reader thread to the caller
+    SpscRing<size_t, CHUNK_COUNT> m_free;           ///< Handled buffers, from the caller back to the reader thread
+    Chunk m_chunk;                                  ///< Buffer the lines are taken from
+    const char* m_position;                         ///< Start of the next line in `m_chunk`, null to take the next buffer
+    string m_carry;                                 ///< Start of a line that continues in the next buffer
+    string m_line;                                  ///< Last line handed out that straddled two buffers
+    bool m_finished;                                ///< Whether every buffer has been taken
+    bool m_failed;                                  ///< Whether the file could not be opened or read
+    std::atomic<bool> m_stop;                       ///< Set when the reader thread must exit
+    std::thread m_reader;                           ///< Thread reading the file
+
+    void read();
+    Chunk nextChunk();
+    void releaseChunk(const Chunk& chunk);
+};
+
+#endif // CHUNKREADER_H_INCLUDED
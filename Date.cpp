@@ -1,19 +1,5 @@
 #include "Date.h"
 
-Date::Date()
-{
-    m_day = 1;
-    m_month = 1;
-    m_year = 2000;
-}
-
-Date::Date(int day, int month, int year)
-{
-    m_day = day;
-    m_month = month;
-    m_year = year;
-}
-
 int Date::GetDay() const
 {
     return m_day;
@@ -42,53 +28,23 @@ void Date::SetYear(int year)
 
 string Date::SetMonthName(int month)
 {
-    Map<int, string> monthMap;
-    monthMap.insert(1, "January");
-    monthMap.insert(2, "February");
-    monthMap.insert(3, "March");
-    monthMap.insert(4, "April");
-    monthMap.insert(5, "May");
-    monthMap.insert(6, "June");
-    monthMap.insert(7, "July");
-    monthMap.insert(8, "August");
-    monthMap.insert(9, "September");
-    monthMap.insert(10, "October");
-    monthMap.insert(11, "November");
-    monthMap.insert(12, "December");
-     if (monthMap.exists(month))
-        return monthMap.get(month);
-     else
-        return "Invalid Month";
+    return Calendar::monthName(month); // Static table, nothing is built per call
 }
 
 bool Date::isValid() const
 {
     if (m_month < 1 || m_month > 12) return false;
-    if (m_day < 1 || m_day > 31) return false;      // Simplified; leap year not considered
-    if (m_month == 2 && m_day > 29) return false;   // Handle February
-    return true;
+    return m_day >= 1 && m_day <= Calendar::daysInMonth(m_month, m_year); // February has 29 days in leap years
 }
 
-bool Date::operator<(const Date& other) const
-{
-        if (this->m_year < other.m_year)
-            return true;
-        if (this->m_year == other.m_year)
-        {
-            if (this->m_month < other.m_month)
-                return true;
-            if (this->m_month == other.m_month)
-                return this->m_day < other.m_day;
-        }
-        return false;
-}
-
-bool Date::operator==(const Date& other) const
-{
-    return this->m_year == other.m_year &&
-           this->m_month == other.m_month &&
-           this->m_day == other.m_day;
-}
+// The calendar arithmetic is constexpr, check it at compile time
+static_assert(Date(1, 1, 1970).GetSerial() == 0, "the serial day count starts on 1 January 1970");
+static_assert(Date(31, 12, 2024).GetDayOfYear() == 366, "2024 is a leap year");
+static_assert(Date(1, 1, 1970).GetDayOfWeek() == 4, "1 January 1970 was a Thursday");
+static_assert(Date::FromSerial(Date(28, 2, 2023).GetSerial() + 1) == Date(1, 3, 2023), "days carry into the next month");
+static_assert(Date::FromSerial(Date(1, 1, Calendar::MIN_YEAR).GetSerial()) == Date(1, 1, Calendar::MIN_YEAR)
+              && Date::FromSerial(Date(31, 12, Calendar::MAX_YEAR).GetSerial()) == Date(31, 12, Calendar::MAX_YEAR),
+              "the serial day conversions hold over the supported years");
 
 ostream& operator<<(ostream& os, const Date& date)
 {
@@ -2,7 +2,8 @@
 #define DATE_H_INCLUDED
 
 #include <iostream>
-#include "map.h"
+#include <string>
+#include "Calendar.h"
 
 using std::istream;
 using std::ostream;
@@ -28,7 +29,7 @@ public:
      *
      * Initializes the Date object to a default value of January 1, 2000.
      */
-    Date();
+    constexpr Date();
 
     /**
      * @brief Parameterized constructor
@@ -40,7 +41,7 @@ public:
      * @param year The year (e.g., 2024)
      * @pre The provided day, month, and year must form a valid calendar date.
      */
-    Date(int day, int month, int year);
+    constexpr Date(int day, int month, int year);
 
     /**
      * @brief Gets the day of the month
@@ -119,27 +120,77 @@ public:
      */
     bool isValid() const;
 
+    /**
+     * @brief Gets the serial day number of the date
+     *
+     * The serial number counts days from 1 January 1970, so the number of days between two
+     * dates is the difference of their serial numbers. It is also the key used to compare dates.
+     *
+     * @return The number of days from 1 January 1970 to the date, negative before it.
+     */
+    constexpr int GetSerial() const;
+
+    /**
+     * @brief Gets the position of the date in its year
+     *
+     * @return The day of the year, from 1 for 1 January to 365 or 366 for 31 December.
+     * @pre The date must be valid.
+     */
+    constexpr int GetDayOfYear() const;
+
+    /**
+     * @brief Gets the weekday of the date
+     *
+     * @return The day of the week, 0 for Sunday to 6 for Saturday.
+     */
+    constexpr int GetDayOfWeek() const;
+
+    /**
+     * @brief Moves the date by a number of days
+     *
+     * Crosses month and year boundaries and accounts for leap years.
+     *
+     * @param days The number of days to add, negative to move backwards.
+     */
+    constexpr void AddDays(int days);
+
+    /**
+     * @brief Counts the days from this date to another
+     *
+     * @param other The other date.
+     * @return The number of days from this date to `other`, negative if `other` is earlier.
+     */
+    constexpr int DaysUntil(const Date& other) const;
+
+    /**
+     * @brief Creates a Date from a serial day number
+     *
+     * @param serial The number of days from 1 January 1970.
+     * @return The Date with that serial number.
+     */
+    static constexpr Date FromSerial(int serial);
+
     /**
      * @brief Comparison operator for less than
      *
      * Compares the current Date object with another Date object to determine if the current
-     * Date is earlier than the other.
+     * Date is earlier than the other, by comparing their serial day numbers.
      *
      * @param other The Date object to compare with.
      * @return true if the current Date is earlier than the other Date.
      */
-    bool operator<(const Date& other) const;
+    constexpr bool operator<(const Date& other) const;
 
     /**
      * @brief Comparison operator for equality
      *
      * Compares the current Date object with another Date object to determine if they represent
-     * the same calendar date.
+     * the same calendar date, by comparing their serial day numbers like `operator<`.
      *
      * @param other The Date object to compare with.
      * @return true if the current Date is equal to the other Date.
      */
-    bool operator==(const Date& other) const;
+    constexpr bool operator==(const Date& other) const;
 
 private:
     int m_day;   ///< Day of the month (1-31)
@@ -147,6 +198,58 @@ private:
     int m_year;  ///< Year (e.g., 2024)
 };
 
+constexpr Date::Date() : m_day(1), m_month(1), m_year(2000)
+{
+}
+
+constexpr Date::Date(int day, int month, int year) : m_day(day), m_month(month), m_year(year)
+{
+}
+
+constexpr int Date::GetSerial() const
+{
+    return Calendar::daysFromCivil(m_year, m_month, m_day);
+}
+
+constexpr int Date::GetDayOfYear() const
+{
+    return Calendar::dayOfYear(m_year, m_month, m_day);
+}
+
+constexpr int Date::GetDayOfWeek() const
+{
+    return Calendar::dayOfWeek(GetSerial());
+}
+
+constexpr void Date::AddDays(int days)
+{
+    Calendar::Civil civil = Calendar::civilFromDays(GetSerial() + days);
+    m_day = civil.day;
+    m_month = civil.month;
+    m_year = civil.year;
+}
+
+constexpr int Date::DaysUntil(const Date& other) const
+{
+    return other.GetSerial() - GetSerial();
+}
+
+constexpr Date Date::FromSerial(int serial)
+{
+    Calendar::Civil civil = Calendar::civilFromDays(serial);
+    return Date(civil.day, civil.month, civil.year);
+}
+
+constexpr bool Date::operator<(const Date& other) const
+{
+    return GetSerial() < other.GetSerial();
+}
+
+constexpr bool Date::operator==(const Date& other) const
+{
+    return GetSerial() == other.GetSerial();
+}
+
 /**
  * @brief Output stream operator for Date
  *
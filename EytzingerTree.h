@@ -0,0 +1,332 @@
+#ifndef EYTZINGERTREE_H_INCLUDED
+#define EYTZINGERTREE_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+/**
+ * @class EytzingerTree
+ * @brief Static, cache-friendly search tree stored implicitly in one array
+ *
+ * The tree is built once from sorted data and cannot be modified afterwards. Values are laid
+ * out in Eytzinger (breadth-first) order: the root is at index 1 and the children of index `k`
+ * are at `2k` and `2k + 1`, so no child pointers are stored at all. The array is aligned to a
+ * cache line and the search loop is branchless and prefetches the descendants a few levels
+ * ahead, so lookups mostly hit cache lines that are already on their way. Nothing but the values
+ * is stored: the rank of a node follows from its index and the size of the tree.
+ *
+ * It is meant for read-mostly data, e.g. a loaded archive, where it answers membership and
+ * rank queries several times faster than the pointer-based `Bst`. It can be built directly
+ * from a `Bst`, since the `Bst` iterators visit the values in ascending order.
+ *
+ * @tparam T The type of the stored values (e.g., int, float). Must be trivially copyable.
+ */
+template <class T>
+class EytzingerTree
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "EytzingerTree stores its values in raw aligned memory");
+
+public:
+    /**
+     * @brief Default constructor
+     *
+     * Creates an empty tree.
+     */
+    EytzingerTree();
+
+    /**
+     * @brief Builds the tree from a sorted range
+     *
+     * Builds the tree in O(n) from the values in `[first, last)`, which must be sorted in
+     * ascending order.
+     *
+     * @tparam ForwardIt A forward iterator, see `build`.
+     * @param first Iterator to the first value.
+     * @param last Iterator past the last value.
+     * @pre The range is sorted in ascending order.
+     */
+    template <class ForwardIt>
+    EytzingerTree(ForwardIt first, ForwardIt last);
+
+    /**
+     * @brief Copy constructor
+     *
+     * Creates a new tree by copying the contents of another tree.
+     *
+     * @param other The tree to copy.
+     */
+    EytzingerTree(const EytzingerTree<T>& other);
+
+    /**
+     * @brief Assignment operator
+     *
+     * Assigns the contents of one tree to another.
+     *
+     * @param other The tree to assign from.
+     * @return A reference to the current tree.
+     */
+    EytzingerTree<T>& operator=(const EytzingerTree<T>& other);
+
+    /**
+     * @brief Destructor
+     *
+     * Frees the value array.
+     */
+    ~EytzingerTree();
+
+    /**
+     * @brief Rebuilds the tree from a sorted range
+     *
+     * Replaces the contents of the tree with the values in `[first, last)` in O(n). The range
+     * is counted before it is read, so it must be a forward range; single-pass input iterators,
+     * e.g. stream iterators, are rejected at compile time.
+     *
+     * @tparam ForwardIt A forward iterator over values convertible to `T`.
+     * @param first Iterator to the first value.
+     * @param last Iterator past the last value.
+     * @pre The range is sorted in ascending order.
+     */
+    template <class ForwardIt>
+    void build(ForwardIt first, ForwardIt last);
+
+    /**
+     * @brief Checks if a value is stored in the tree
+     *
+     * @param value The value to search for.
+     * @return `true` if the value is found, `false` otherwise.
+     */
+    bool search(const T& value) const;
+
+    /**
+     * @brief Finds the smallest stored value that is not less than the given value
+     *
+     * @param value The value to search for.
+     * @return A pointer to the found value, or `nullptr` if every value is less than `value`.
+     */
+    const T* lowerBound(const T& value) const;
+
+    /**
+     * @brief Counts the stored values that are less than the given value
+     *
+     * This is the position `value` would have in the sorted input.
+     *
+     * @param value The value to rank.
+     * @return The number of stored values less than `value`.
+     */
+    size_t rank(const T& value) const;
+
+    /**
+     * @brief Gets the number of values in the tree
+     *
+     * @return The number of values stored.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks if the tree is empty
+     *
+     * @return `true` if the tree holds no values, `false` otherwise.
+     */
+    bool isEmpty() const;
+
+private:
+    static const size_t CACHE_LINE = 64;  ///< Alignment of the value array in bytes
+    /// Number of values sharing one cache line, used to prefetch four levels ahead
+    static const size_t VALUES_PER_LINE = (sizeof(T) < CACHE_LINE) ? CACHE_LINE / sizeof(T) : 1;
+
+    void* m_block;  ///< Raw allocation holding the aligned value array
+    T* m_values;    ///< Values in Eytzinger order, index 0 unused
+    size_t m_size;  ///< Number of values stored
+
+    void allocate(size_t count);
+    void release();
+    template <class ForwardIt>
+    void fill(ForwardIt& source, size_t index);
+    size_t lowerBoundIndex(const T& value) const;
+    size_t sortedPosition(size_t index) const;
+    static int floorLog2(size_t value);
+};
+
+template <class T>
+EytzingerTree<T>::EytzingerTree() : m_block(nullptr), m_values(nullptr), m_size(0) {}
+
+template <class T>
+template <class ForwardIt>
+EytzingerTree<T>::EytzingerTree(ForwardIt first, ForwardIt last) : m_block(nullptr), m_values(nullptr), m_size(0)
+{
+    build(first, last);
+}
+
+template <class T>
+EytzingerTree<T>::EytzingerTree(const EytzingerTree<T>& other) : m_block(nullptr), m_values(nullptr), m_size(0)
+{
+    *this = other;
+}
+
+template <class T>
+EytzingerTree<T>& EytzingerTree<T>::operator=(const EytzingerTree<T>& other)
+{
+    if (this != &other)
+    {
+        allocate(other.m_size);
+        for (size_t k = 1; k <= m_size; k++)
+            m_values[k] = other.m_values[k];
+    }
+    return *this;
+}
+
+template <class T>
+EytzingerTree<T>::~EytzingerTree()
+{
+    release();
+}
+
+template <class T>
+template <class ForwardIt>
+void EytzingerTree<T>::build(ForwardIt first, ForwardIt last)
+{
+    static_assert(std::is_base_of<std::forward_iterator_tag,
+                                  typename std::iterator_traits<ForwardIt>::iterator_category>::value,
+                  "EytzingerTree counts the range before reading it, so it needs a forward iterator");
+    allocate(std::distance(first, last));
+    fill(first, 1);  // In-order walk of the implicit tree consumes the sorted input
+}
+
+template <class T>
+template <class ForwardIt>
+void EytzingerTree<T>::fill(ForwardIt& source, size_t index)
+{
+    if (index > m_size)
+        return;
+    fill(source, 2 * index);
+    m_values[index] = *source;
+    ++source;
+    fill(source, 2 * index + 1);
+}
+
+template <class T>
+size_t EytzingerTree<T>::lowerBoundIndex(const T& value) const
+{
+    size_t k = 1;
+    while (k <= m_size)
+    {
+#if defined(__GNUC__)
+        __builtin_prefetch(m_values + k * VALUES_PER_LINE);  // Descendants four levels down
+#endif
+        k = 2 * k + (m_values[k] < value);  // Branchless: go right when the node is smaller
+    }
+    // The answer is the last node where the search went left: drop the trailing right turns
+    // and that final left turn
+#if defined(__GNUC__)
+    k >>= __builtin_ffsll(~static_cast<long long>(k));
+#else
+    while (k & 1)
+        k >>= 1;
+    k >>= 1;
+#endif
+    return k;  // 0 when every value is less than the searched one
+}
+
+/**
+ * @brief Gets the position in the sorted input of the value stored at an index
+ *
+ * In a perfect tree of `levels` levels, the node at offset `i` of depth `d` is at in-order
+ * position `(2i + 1) * 2^(levels - 1 - d) - 1`, and the bottom level takes the even positions.
+ * The bottom level here is only filled from the left, so the missing bottom nodes that would
+ * come before the node are subtracted.
+ *
+ * @param index The index of a stored value, from 1 to `m_size`.
+ * @return The number of stored values before it in sorted order.
+ */
+template <class T>
+size_t EytzingerTree<T>::sortedPosition(size_t index) const
+{
+    int bottom = floorLog2(m_size);  // Depth of the last level
+    int depth = floorLog2(index);
+    size_t offset = index - (size_t(1) << depth);
+    size_t position = ((2 * offset + 1) << (bottom - depth)) - 1;
+    size_t bottomCount = m_size - (size_t(1) << bottom) + 1;  // Nodes present on the last level
+    size_t bottomBefore = (position + 1) / 2;                 // Bottom slots before the node
+    return (bottomBefore > bottomCount) ? position - (bottomBefore - bottomCount) : position;
+}
+
+/**
+ * @brief Gets the depth of an index in the implicit tree
+ *
+ * @param value A positive index.
+ * @return The largest `d` with `2^d <= value`.
+ */
+template <class T>
+int EytzingerTree<T>::floorLog2(size_t value)
+{
+#if defined(__GNUC__)
+    return static_cast<int>(sizeof(unsigned long long) * 8) - 1 - __builtin_clzll(value);
+#else
+    int log = 0;
+    while (value >>= 1)
+        log++;
+    return log;
+#endif
+}
+
+template <class T>
+bool EytzingerTree<T>::search(const T& value) const
+{
+    size_t k = lowerBoundIndex(value);
+    return k != 0 && !(value < m_values[k]);
+}
+
+template <class T>
+const T* EytzingerTree<T>::lowerBound(const T& value) const
+{
+    size_t k = lowerBoundIndex(value);
+    return (k == 0) ? nullptr : &m_values[k];
+}
+
+template <class T>
+size_t EytzingerTree<T>::rank(const T& value) const
+{
+    size_t k = lowerBoundIndex(value);
+    return (k == 0) ? m_size : sortedPosition(k);
+}
+
+template <class T>
+size_t EytzingerTree<T>::size() const
+{
+    return m_size;
+}
+
+template <class T>
+bool EytzingerTree<T>::isEmpty() const
+{
+    return m_size == 0;
+}
+
+template <class T>
+void EytzingerTree<T>::allocate(size_t count)
+{
+    release();
+    if (count == 0)
+        return;
+    // Over-allocate by one cache line so the array can start on a line boundary
+    m_block = ::operator new((count + 1) * sizeof(T) + CACHE_LINE);
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(m_block);
+    address = (address + CACHE_LINE - 1) & ~static_cast<std::uintptr_t>(CACHE_LINE - 1);
+    m_values = reinterpret_cast<T*>(address);
+    m_size = count;
+}
+
+template <class T>
+void EytzingerTree<T>::release()
+{
+    ::operator delete(m_block);
+    m_block = nullptr;
+    m_values = nullptr;
+    m_size = 0;
+}
+
+#endif // EYTZINGERTREE_H_INCLUDED
@@ -0,0 +1,240 @@
+#ifndef GENERATOR_H_INCLUDED
+#define GENERATOR_H_INCLUDED
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @class Generator
+ * @brief Lazy sequence of values produced by a coroutine
+ *
+ * A function returning a `Generator<T>` is a coroutine that hands out values with `co_yield`.
+ * Nothing runs until the first value is asked for, and the coroutine is suspended after each
+ * value until the next one is asked for, so a consumer that stops early, e.g. with `break`,
+ * never makes the coroutine produce the rest. Values are handed out by reference, without a
+ * copy, and stay valid until the next value is asked for.
+ *
+ * Stages such as `filter`, `map`, `takeWhile` and `dropWhile` wrap a generator in another
+ * one, so pipelines compose: `readRecords(file).filter(inMonth).map(windSpeed)`. Each stage
+ * pulls one value at a time from the stage before it, and nothing is stored in between.
+ *
+ * An exception thrown by the coroutine is rethrown to the consumer. Generators can be moved,
+ * not copied, and are iterated once, with a range-based `for`.
+ *
+ * @tparam T The type of the values.
+ */
+template <class T>
+class Generator
+{
+public:
+    /// State of the coroutine, as required by the compiler
+    struct promise_type
+    {
+        const T* value = nullptr;  ///< Last value yielded, lives in the coroutine until it resumes
+        std::exception_ptr error;  ///< Exception thrown by the coroutine
+
+        Generator get_return_object() { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() { error = std::current_exception(); }
+
+        std::suspend_always yield_value(const T& yielded) noexcept
+        {
+            value = std::addressof(yielded);
+            return {};
+        }
+
+        /// A generator only suspends to yield values
+        template <class U>
+        void await_transform(U&&) = delete;
+    };
+
+    /// Input iterator over the values, ends at `std::default_sentinel`
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        iterator() = default;
+        explicit iterator(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+        const T& operator*() const { return *m_handle.promise().value; }
+        const T* operator->() const { return m_handle.promise().value; }
+
+        iterator& operator++()
+        {
+            resume(m_handle);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return !m_handle || m_handle.done(); }
+
+    private:
+        std::coroutine_handle<promise_type> m_handle;  ///< Coroutine producing the values
+    };
+
+    Generator() = default;
+    Generator(Generator&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+    Generator& operator=(Generator&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Destructor, ends the coroutine where it is suspended, destroying its locals
+     */
+    ~Generator()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+    /**
+     * @brief Runs the coroutine up to its first value
+     *
+     * @return An iterator to the first value.
+     */
+    iterator begin()
+    {
+        if (m_handle)
+            resume(m_handle);
+        return iterator(m_handle);
+    }
+
+    /**
+     * @brief Marks the end of the values
+     *
+     * @return The sentinel that iterators reach once the coroutine returns.
+     */
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+
+    /**
+     * @brief Keeps the values that satisfy a condition
+     *
+     * @param keep Called with each value, returns `true` to keep it.
+     * @return A generator of the values kept.
+     */
+    template <class Predicate>
+    Generator filter(Predicate keep) &&
+    {
+        return filterStage(std::move(*this), std::move(keep));
+    }
+
+    /**
+     * @brief Keeps the values up to the first one that does not satisfy a condition
+     *
+     * The generator is not asked for any value after that one, so the values are read no further.
+     *
+     * @param keep Called with each value, returns `false` to end the sequence.
+     * @return A generator of the values before the first one rejected.
+     */
+    template <class Predicate>
+    Generator takeWhile(Predicate keep) &&
+    {
+        return takeWhileStage(std::move(*this), std::move(keep));
+    }
+
+    /**
+     * @brief Skips the values up to the first one that does not satisfy a condition
+     *
+     * @param skip Called with each value until it returns `false`, returns `true` to skip it.
+     * @return A generator of the values from the first one not skipped.
+     */
+    template <class Predicate>
+    Generator dropWhile(Predicate skip) &&
+    {
+        return dropWhileStage(std::move(*this), std::move(skip));
+    }
+
+    /**
+     * @brief Replaces each value with the result of a function
+     *
+     * @param project Called with each value, returns the value to hand out instead.
+     * @return A generator of the results.
+     */
+    template <class Function>
+    Generator<std::decay_t<std::invoke_result_t<Function&, const T&>>> map(Function project) &&
+    {
+        return mapStage(std::move(*this), std::move(project));
+    }
+
+private:
+    template <class U>
+    friend class Generator;
+
+    std::coroutine_handle<promise_type> m_handle;  ///< Coroutine producing the values, none once moved from
+
+    explicit Generator(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+    /// Runs the coroutine up to its next value, rethrowing what it threw
+    static void resume(std::coroutine_handle<promise_type> handle)
+    {
+        handle.resume();
+        if (handle.promise().error)
+            std::rethrow_exception(std::exchange(handle.promise().error, nullptr));
+    }
+
+    template <class Predicate>
+    static Generator filterStage(Generator source, Predicate keep)
+    {
+        for (const T& value : source)
+        {
+            if (keep(value))
+                co_yield value;
+        }
+    }
+
+    template <class Predicate>
+    static Generator takeWhileStage(Generator source, Predicate keep)
+    {
+        for (const T& value : source)
+        {
+            if (!keep(value))
+                co_return;
+            co_yield value;
+        }
+    }
+
+    template <class Predicate>
+    static Generator dropWhileStage(Generator source, Predicate skip)
+    {
+        bool skipping = true;
+        for (const T& value : source)
+        {
+            skipping = skipping && skip(value);
+            if (!skipping)
+                co_yield value;
+        }
+    }
+
+    template <class Function>
+    static Generator<std::decay_t<std::invoke_result_t<Function&, const T&>>> mapStage(Generator source,
+                                                                                        Function project)
+    {
+        for (const T& value : source)
+            co_yield project(value);  // The result lives until the consumer asks for the next one
+    }
+};
+
+#endif // GENERATOR_H_INCLUDED
@@ -0,0 +1,94 @@
+#include "Vector.h"
+#include "Bst.h"
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+namespace
+{
+    const size_t ELEMENT_COUNT = (size_t(1) << 31) + 6;  // Past the largest int index
+
+    int g_failures = 0;
+
+    /**
+     * @brief Reports a failed check
+     *
+     * @param passed Whether the check passed.
+     * @param what Description of the check.
+     */
+    void check(bool passed, const char* what)
+    {
+        if (!passed)
+        {
+            cout << "FAILED: " << what << endl;
+            g_failures++;
+        }
+    }
+
+    /**
+     * @brief Gets the value stored at an index
+     *
+     * The low byte of the index with its bits reversed, so the first 256 values inserted into a
+     * `Bst` spread over the range and keep the tree about eight levels deep.
+     *
+     * @param index The index.
+     * @return The value for that index.
+     */
+    uint8_t valueAt(size_t index)
+    {
+        uint8_t value = 0;
+        for (int bit = 0; bit < 8; bit++)
+            value |= ((index >> bit) & 1) << (7 - bit);
+        return value ^ 0x80;
+    }
+}
+
+/**
+ * @brief Checks Vector and Bst sizes and indices past 2^31 elements
+ *
+ * Uses one-byte elements so the vector needs about 2 GiB. The storage is reserved up front,
+ * since growing by doubling would briefly hold the old and new arrays together.
+ *
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main()
+{
+    Vector<uint8_t> values;
+    values.Reserve(ELEMENT_COUNT);
+    for (size_t i = 0; i < ELEMENT_COUNT; i++)
+        values.Add(valueAt(i));
+
+    check(values.size() == ELEMENT_COUNT, "Vector::size() counts past 2^31");
+    check(values[0] == valueAt(0), "Vector indexing at the first element");
+    check(values[ELEMENT_COUNT - 1] == valueAt(ELEMENT_COUNT - 1), "Vector indexing at the last element");
+    check(values.at(size_t(1) << 31) == valueAt(size_t(1) << 31), "Vector::at() at index 2^31");
+    check(values.Modify(ELEMENT_COUNT - 1, 7) && values[ELEMENT_COUNT - 1] == 7, "Vector::Modify() past 2^31");
+    values.Modify(ELEMENT_COUNT - 1, valueAt(ELEMENT_COUNT - 1));
+
+    Bst<uint8_t> tree;
+    for (size_t i = 0; i < values.size(); i++)
+        tree.insert(values[i]);
+    check(tree.count() == ELEMENT_COUNT, "Bst::count() counts past 2^31");
+
+    size_t counted = 0;
+    size_t distinct = 0;
+    tree.inOrderCounted([&counted, &distinct](uint8_t, size_t multiplicity)
+    {
+        counted += multiplicity;
+        distinct++;
+    });
+    check(counted == ELEMENT_COUNT, "Bst multiplicities add up past 2^31");
+    check(distinct == 256, "Bst holds every byte value once");
+
+    values.Clear();
+    values.Shrink();
+    tree.clear();
+
+    if (g_failures > 0)
+        return 1;
+    cout << "All large-dataset checks passed" << endl;
+    return 0;
+}
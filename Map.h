@@ -2,22 +2,26 @@
 #define MAP_H_INCLUDED
 
 #include <iostream>
-#include <map>
-
-using std::map;
+#include "MapBackend.h"
 
 /**
  * @class Map
- * @brief A simple template-based wrapper around the STL map container
+ * @brief A simple template-based key-value map with selectable storage
  *
- * This class provides a basic interface for working with key-value pairs using a `std::map`.
+ * This class provides a basic interface for working with key-value pairs, by default in a `std::map`.
  * It supports basic operations like inserting key-value pairs, retrieving values by key,
  * checking if a key exists, and getting the size of the map.
  *
+ * The storage is selected with `Backend`: `TreeMapBackend` (a `std::map`, the default),
+ * `FlatHashMapBackend` (open addressing with SIMD-probed control bytes, for large maps with
+ * many lookups) or `FlatSortedMapBackend` (a sorted array, for small or read-mostly maps).
+ * Both flat backends keep the entries in contiguous memory with no allocation per entry.
+ *
  * @tparam T The type of the key in the map.
  * @tparam U The type of the value associated with the key.
+ * @tparam Backend The storage of the key-value pairs.
  */
-template <class T, class U>
+template <class T, class U, template <class, class> class Backend = TreeMapBackend>
 class Map
 {
 public:
@@ -60,25 +64,25 @@ public:
      *
      * @return The number of key-value pairs in the map.
      */
-    int size() const;
+    size_t size() const;
 
 private:
-    map<T, U> m_map;  ///< Underlying `std::map` to store key-value pairs
+    Backend<T, U> m_map;  ///< Underlying storage of the key-value pairs
 };
 
 /**
  * @brief Inserts a key-value pair into the map
  *
- * This function inserts a key-value pair into the underlying `std::map`. If the key already
+ * This function inserts a key-value pair into the underlying storage. If the key already
  * exists, the value is updated with the new value.
  *
  * @param key The key to insert.
  * @param value The value to associate with the key.
  */
-template <class T, class U>
-void Map<T, U>::insert(const T& key, const U& value)
+template <class T, class U, template <class, class> class Backend>
+void Map<T, U, Backend>::insert(const T& key, const U& value)
 {
-    m_map[key] = value;  ///< Insert or update the key-value pair
+    m_map.insert(key, value);  ///< Insert or update the key-value pair
 }
 
 /**
@@ -90,16 +94,16 @@ void Map<T, U>::insert(const T& key, const U& value)
  * @param key The key whose associated value is to be retrieved.
  * @return The value associated with the key, or a default value if the key is not found.
  */
-template <class T, class U>
-U Map<T, U>::get(const T& key) const
+template <class T, class U, template <class, class> class Backend>
+U Map<T, U, Backend>::get(const T& key) const
 {
     // If the key doesn't exist, return an empty (default-constructed) value
-    auto iter = m_map.find(key);
-    if (iter == m_map.end())
+    const U* value = m_map.find(key);
+    if (value == nullptr)
     {
         return U();  ///< Return the default value of type U (e.g., 0 for numeric types)
     }
-    return iter->second;  ///< Return the associated value
+    return *value;  ///< Return the associated value
 }
 
 /**
@@ -111,10 +115,10 @@ U Map<T, U>::get(const T& key) const
  * @param key The key to check for existence.
  * @return `true` if the key exists in the map, `false` otherwise.
  */
-template <class T, class U>
-bool Map<T, U>::exists(const T& key) const
+template <class T, class U, template <class, class> class Backend>
+bool Map<T, U, Backend>::exists(const T& key) const
 {
-    return m_map.find(key) != m_map.end();  ///< Check if key is present in the map
+    return m_map.find(key) != nullptr;  ///< Check if key is present in the map
 }
 
 /**
@@ -124,8 +128,8 @@ bool Map<T, U>::exists(const T& key) const
  *
  * @return The number of key-value pairs in the map.
  */
-template <class T, class U>
-int Map<T, U>::size() const
+template <class T, class U, template <class, class> class Backend>
+size_t Map<T, U, Backend>::size() const
 {
     return m_map.size();  ///< Return the size of the map
 }
@@ -0,0 +1,243 @@
+#ifndef MAPBACKEND_H_INCLUDED
+#define MAPBACKEND_H_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @class TreeMapBackend
+ * @brief `Map` storage in a `std::map`
+ *
+ * A red-black tree with one allocation per entry. Keys only need `operator<`. This is the
+ * default backend of `Map`.
+ *
+ * @tparam K The type of the keys.
+ * @tparam V The type of the values.
+ */
+template <class K, class V>
+class TreeMapBackend
+{
+public:
+    void insert(const K& key, const V& value)  ///< Insert or update a key-value pair
+    {
+        m_map[key] = value;
+    }
+
+    const V* find(const K& key) const  ///< Return the value of a key, `nullptr` if absent
+    {
+        auto iter = m_map.find(key);
+        return (iter == m_map.end()) ? nullptr : &iter->second;
+    }
+
+    size_t size() const { return m_map.size(); }  ///< Return the number of keys
+
+private:
+    std::map<K, V> m_map;  ///< Underlying `std::map`
+};
+
+/**
+ * @class FlatSortedMapBackend
+ * @brief `Map` storage in one sorted array of key-value pairs
+ *
+ * Lookups are a binary search over contiguous memory, so a small or rarely modified map stays
+ * in a few cache lines with no allocation per entry. Inserting a new key shifts the following
+ * entries and is O(n). Keys only need `operator<`.
+ *
+ * @tparam K The type of the keys.
+ * @tparam V The type of the values.
+ */
+template <class K, class V>
+class FlatSortedMapBackend
+{
+public:
+    void insert(const K& key, const V& value)  ///< Insert or update a key-value pair
+    {
+        auto iter = lowerBound(key);
+        if (iter != m_entries.end() && !(key < iter->first))
+            iter->second = value;
+        else
+            m_entries.insert(iter, std::make_pair(key, value));
+    }
+
+    const V* find(const K& key) const  ///< Return the value of a key, `nullptr` if absent
+    {
+        auto iter = std::lower_bound(m_entries.begin(), m_entries.end(), key, keyLess);
+        return (iter != m_entries.end() && !(key < iter->first)) ? &iter->second : nullptr;
+    }
+
+    size_t size() const { return m_entries.size(); }  ///< Return the number of keys
+
+private:
+    std::vector<std::pair<K, V>> m_entries;  ///< Entries sorted by key
+
+    static bool keyLess(const std::pair<K, V>& entry, const K& key) { return entry.first < key; }
+
+    typename std::vector<std::pair<K, V>>::iterator lowerBound(const K& key)
+    {
+        return std::lower_bound(m_entries.begin(), m_entries.end(), key, keyLess);
+    }
+};
+
+/**
+ * @class FlatHashMapBackend
+ * @brief `Map` storage in an open-addressing hash table with SIMD-probed control bytes
+ *
+ * Entries live in one flat array, next to a parallel array of one-byte control words. A
+ * control byte is either `EMPTY` or the low 7 bits of the hash of the key stored in its slot.
+ * A lookup hashes the key once, then scans the control bytes 16 at a time, so one SSE2
+ * comparison finds every slot of a group that may hold the key and whether the group has an
+ * empty slot that ends the search. Keys are compared only on a 7-bit hash match, which is
+ * rare for other keys. Groups are probed triangularly, which visits every group of the
+ * power-of-two table, and the table doubles before it is 7/8 full.
+ *
+ * Keys need `std::hash` and `operator==`. Keys and values must be default constructible.
+ *
+ * @tparam K The type of the keys.
+ * @tparam V The type of the values.
+ */
+template <class K, class V>
+class FlatHashMapBackend
+{
+public:
+    FlatHashMapBackend() : m_size(0) {}
+
+    void insert(const K& key, const V& value)  ///< Insert or update a key-value pair
+    {
+        size_t hash = hashOf(key);
+        size_t index = findIndex(key, hash);
+        if (index != NOT_FOUND)
+        {
+            m_slots[index].second = value;
+            return;
+        }
+        if ((m_size + 1) * 8 > m_slots.size() * 7)
+            rehash(m_slots.empty() ? GROUP : m_slots.size() * 2);
+        place(hash, key, value);
+    }
+
+    const V* find(const K& key) const  ///< Return the value of a key, `nullptr` if absent
+    {
+        size_t index = findIndex(key, hashOf(key));
+        return (index == NOT_FOUND) ? nullptr : &m_slots[index].second;
+    }
+
+    size_t size() const { return m_size; }  ///< Return the number of keys
+
+private:
+    static constexpr size_t GROUP = 16;                    ///< Control bytes compared at once
+    static constexpr signed char EMPTY = -128;             ///< Control byte of an unused slot
+    static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);  ///< Index returned for a missing key
+
+    std::vector<signed char> m_control;        ///< One control byte per slot
+    std::vector<std::pair<K, V>> m_slots;      ///< Entries, valid where the control byte is not EMPTY
+    size_t m_size;                             ///< Number of keys stored
+
+    static size_t hashOf(const K& key)
+    {
+        // std::hash is the identity for integers, so mix the bits before splitting the hash
+        uint64_t hash = static_cast<uint64_t>(std::hash<K>()(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+
+    static signed char tagOf(size_t hash) { return static_cast<signed char>(hash & 0x7F); }
+
+    /// Position of the lowest set bit of a non-zero mask
+    static size_t lowestBit(unsigned mask)
+    {
+#if defined(__GNUC__)
+        return __builtin_ctz(mask);
+#else
+        size_t bit = 0;
+        while (!(mask & 1u))
+        {
+            mask >>= 1;
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    /// Bit i is set when control byte i of the group equals `tag`
+    static unsigned matchGroup(const signed char* group, signed char tag)
+    {
+#if defined(__SSE2__) && defined(__GNUC__)
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(tag))));
+#else
+        unsigned mask = 0;
+        for (size_t i = 0; i < GROUP; i++)
+            mask |= static_cast<unsigned>(group[i] == tag) << i;
+        return mask;
+#endif
+    }
+
+    size_t findIndex(const K& key, size_t hash) const
+    {
+        if (m_size == 0)
+            return NOT_FOUND;
+        size_t groups = m_slots.size() / GROUP;
+        size_t group = (hash >> 7) & (groups - 1);
+        signed char tag = tagOf(hash);
+        for (size_t step = 1; step <= groups; step++)
+        {
+            const signed char* control = &m_control[group * GROUP];
+            for (unsigned mask = matchGroup(control, tag); mask != 0; mask &= mask - 1)
+            {
+                size_t index = group * GROUP + lowestBit(mask);
+                if (m_slots[index].first == key)
+                    return index;
+            }
+            if (matchGroup(control, EMPTY) != 0)
+                return NOT_FOUND;  // An empty slot ends the probe sequence of every key
+            group = (group + step) & (groups - 1);
+        }
+        return NOT_FOUND;
+    }
+
+    void place(size_t hash, K key, V value)
+    {
+        size_t groups = m_slots.size() / GROUP;
+        size_t group = (hash >> 7) & (groups - 1);
+        for (size_t step = 1;; step++)
+        {
+            unsigned empty = matchGroup(&m_control[group * GROUP], EMPTY);
+            if (empty != 0)
+            {
+                size_t index = group * GROUP + lowestBit(empty);
+                m_control[index] = tagOf(hash);
+                m_slots[index] = std::make_pair(std::move(key), std::move(value));
+                m_size++;
+                return;
+            }
+            group = (group + step) & (groups - 1);
+        }
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<signed char> control(capacity, EMPTY);
+        std::vector<std::pair<K, V>> slots(capacity);
+        control.swap(m_control);
+        slots.swap(m_slots);
+        m_size = 0;
+        for (size_t i = 0; i < slots.size(); i++)
+        {
+            if (control[i] != EMPTY)
+            {
+                size_t hash = hashOf(slots[i].first);  // Before the key is moved from
+                place(hash, std::move(slots[i].first), std::move(slots[i].second));
+            }
+        }
+    }
+};
+
+#endif // MAPBACKEND_H_INCLUDED
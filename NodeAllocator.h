@@ -0,0 +1,240 @@
+#ifndef NODEALLOCATOR_H_INCLUDED
+#define NODEALLOCATOR_H_INCLUDED
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @class HeapAllocator
+ * @brief Node allocation policy that allocates every node individually on the heap
+ *
+ * This policy creates each node with `new` and destroys it with `delete`. It has no state
+ * and cannot release a whole tree at once, so a container using it has to visit every node
+ * when it is destroyed.
+ *
+ * @tparam NodeT The node type to allocate (e.g., `Node<float>`).
+ */
+template <class NodeT>
+class HeapAllocator
+{
+public:
+    /// `true` if `releaseAll` frees every node without visiting them individually
+    static const bool releasesInBulk = false;
+
+    /**
+     * @brief Creates a node holding the given value
+     *
+     * @param value The value to store in the new node.
+     * @return A pointer to the new node.
+     */
+    template <class V>
+    NodeT* create(V&& value)
+    {
+        return new NodeT(std::forward<V>(value));
+    }
+
+    /**
+     * @brief Destroys a node previously created by this allocator
+     *
+     * @param node The node to destroy.
+     */
+    void destroy(NodeT* node)
+    {
+        delete node;
+    }
+
+    /**
+     * @brief Releases all nodes at once
+     *
+     * Nothing to do for this policy, every node has already been destroyed individually.
+     */
+    void releaseAll() {}
+};
+
+/**
+ * @class PoolAllocator
+ * @brief Node allocation policy backed by a slab pool with a bump pointer
+ *
+ * Nodes are carved out of large contiguous slabs, so neighbouring nodes share cache lines and
+ * an insert costs a pointer bump instead of a call to the heap. Each new slab is twice as big
+ * as the previous one (up to a cap), so filling the pool takes O(log n) heap allocations.
+ * Destroyed nodes go on a free list and are reused by the next `create`.
+ *
+ * When the node type is trivially destructible, `releaseAll` frees every node by returning
+ * the slabs to the heap, without walking the tree.
+ *
+ * The pool belongs to exactly one container. It cannot be copied, but moving it hands every
+ * slab, and so every node, over to the new owner.
+ *
+ * @tparam NodeT The node type to allocate (e.g., `Node<float>`).
+ */
+template <class NodeT>
+class PoolAllocator
+{
+public:
+    /// `true` if `releaseAll` frees every node without visiting them individually
+    static const bool releasesInBulk = std::is_trivially_destructible<NodeT>::value;
+
+    /**
+     * @brief Default constructor
+     *
+     * Creates an empty pool, the first slab is allocated on the first `create`.
+     */
+    PoolAllocator() : m_next(nullptr), m_end(nullptr), m_freeList(nullptr), m_slabSize(0) {}
+
+    /**
+     * @brief Destructor
+     *
+     * Returns every slab to the heap.
+     */
+    ~PoolAllocator()
+    {
+        releaseAll();
+    }
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    /**
+     * @brief Move constructor
+     *
+     * Takes over the slabs of another pool, which is left empty.
+     *
+     * @param other The pool to move from.
+     */
+    PoolAllocator(PoolAllocator&& other) noexcept
+        : m_slabs(std::move(other.m_slabs)), m_next(other.m_next), m_end(other.m_end),
+          m_freeList(other.m_freeList), m_slabSize(other.m_slabSize)
+    {
+        other.forget();
+    }
+
+    /**
+     * @brief Move assignment operator
+     *
+     * Releases the slabs of this pool and takes over those of another pool, which is left empty.
+     *
+     * @param other The pool to move from.
+     * @return A reference to this pool.
+     */
+    PoolAllocator& operator=(PoolAllocator&& other) noexcept
+    {
+        if (this != &other)
+        {
+            releaseAll();
+            m_slabs.swap(other.m_slabs);
+            m_next = other.m_next;
+            m_end = other.m_end;
+            m_freeList = other.m_freeList;
+            m_slabSize = other.m_slabSize;
+            other.forget();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Creates a node holding the given value
+     *
+     * Reuses a previously destroyed node if there is one, otherwise bumps the pointer in the
+     * current slab, starting a new slab when it is full.
+     *
+     * @param value The value to store in the new node.
+     * @return A pointer to the new node.
+     */
+    template <class V>
+    NodeT* create(V&& value)
+    {
+        void* slot;
+        if (m_freeList != nullptr)
+        {
+            slot = m_freeList;
+            m_freeList = m_freeList->next;
+        }
+        else
+        {
+            if (m_next == m_end)
+                addSlab();
+            slot = m_next;
+            m_next += sizeof(Slot);
+        }
+        return new (slot) NodeT(std::forward<V>(value));
+    }
+
+    /**
+     * @brief Destroys a node previously created by this pool
+     *
+     * Runs the node's destructor and puts its slot on the free list.
+     *
+     * @param node The node to destroy.
+     */
+    void destroy(NodeT* node)
+    {
+        node->~NodeT();
+        FreeSlot* slot = reinterpret_cast<FreeSlot*>(node);
+        slot->next = m_freeList;
+        m_freeList = slot;
+    }
+
+    /**
+     * @brief Releases all nodes at once
+     *
+     * Returns every slab to the heap. Node destructors are not run, so nodes of a type that
+     * is not trivially destructible must be destroyed with `destroy` first.
+     */
+    void releaseAll()
+    {
+        for (size_t i = 0; i < m_slabs.size(); i++)
+            ::operator delete(m_slabs[i]);
+        m_slabs.clear();
+        m_next = m_end = nullptr;
+        m_freeList = nullptr;
+        m_slabSize = 0;
+    }
+
+private:
+    static const size_t FIRST_SLAB_NODES = 64;     ///< Nodes in the first slab
+    static const size_t MAX_SLAB_NODES = 65536;    ///< Slabs stop growing at this many nodes
+
+    struct FreeSlot
+    {
+        FreeSlot* next;  ///< Next free slot
+    };
+
+    /// Storage for one node, large enough to also hold a free list link
+    union Slot
+    {
+        FreeSlot link;
+        typename std::aligned_storage<sizeof(NodeT), alignof(NodeT)>::type node;
+    };
+
+    std::vector<void*> m_slabs;  ///< Every slab allocated so far
+    char* m_next;                ///< Next unused slot in the current slab
+    char* m_end;                 ///< End of the current slab
+    FreeSlot* m_freeList;        ///< Slots of destroyed nodes, ready for reuse
+    size_t m_slabSize;           ///< Number of nodes in the current slab
+
+    void forget()
+    {
+        m_slabs.clear();
+        m_next = m_end = nullptr;
+        m_freeList = nullptr;
+        m_slabSize = 0;
+    }
+
+    void addSlab()
+    {
+        m_slabSize = (m_slabSize == 0) ? FIRST_SLAB_NODES : m_slabSize * 2;
+        if (m_slabSize > MAX_SLAB_NODES)
+            m_slabSize = MAX_SLAB_NODES;
+        m_slabs.reserve(m_slabs.size() + 1);  // Never leak the slab if the bookkeeping throws
+        char* slab = static_cast<char*>(::operator new(m_slabSize * sizeof(Slot)));
+        m_slabs.push_back(slab);
+        m_next = slab;
+        m_end = slab + m_slabSize * sizeof(Slot);
+    }
+};
+
+#endif // NODEALLOCATOR_H_INCLUDED
@@ -0,0 +1,577 @@
+#ifndef ORDERSTATBST_H_INCLUDED
+#define ORDERSTATBST_H_INCLUDED
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "NodeAllocator.h"
+#include "Bst.h"
+
+/**
+ * @class OrderStatNode
+ * @brief Node of an `OrderStatBst`, augmented with subtree aggregates
+ *
+ * Besides the value and the child pointers, each node caches the height, the number of
+ * values and the sum of the values in the subtree it roots.
+ *
+ * @tparam T Type of data stored in the node (e.g., int, float).
+ */
+template <class T>
+class OrderStatNode
+{
+public:
+    T data;                ///< Data stored in the node
+    OrderStatNode* left;   ///< Pointer to the left child node
+    OrderStatNode* right;  ///< Pointer to the right child node
+    int height;            ///< Height of the subtree rooted here (leaf = 1)
+    size_t size;           ///< Number of values in the subtree rooted here
+    T total;               ///< Sum of the values in the subtree rooted here
+
+    /**
+     * @brief Constructor for OrderStatNode class
+     *
+     * Initializes a leaf node with the given value.
+     *
+     * @param value The data to store in the node.
+     */
+    OrderStatNode(T value)
+    {
+        data = value;     ///< Initialize data
+        left = nullptr;   ///< Initialize left pointer
+        right = nullptr;  ///< Initialize right pointer
+        height = 1;       ///< A leaf has height 1
+        size = 1;         ///< A leaf holds one value
+        total = value;    ///< A leaf sums to its own value
+    }
+};
+
+/**
+ * @class OrderStatBst
+ * @brief Balanced Binary Search Tree with order-statistic and sum augmentation
+ *
+ * This class is a variant of `Bst` where every node keeps the size and the sum of its subtree.
+ * The aggregates are maintained on insert, remove and on every rotation of the AVL rebalancing,
+ * so `count` and `sum` are O(1), and `rank`, `select` (for medians and percentiles) and
+ * `rangeSum` run in O(log n).
+ *
+ * Equal values are kept as separate nodes, so every copy is counted and summed; a new copy is
+ * placed to the right of the equal values already stored.
+ *
+ * @tparam T The type of the data stored in the tree nodes (e.g., int, float).
+ * @tparam Alloc The node allocation policy (e.g., `PoolAllocator`, `HeapAllocator`).
+ */
+template <class T, template <class> class Alloc = PoolAllocator>
+class OrderStatBst
+{
+private:
+    typedef OrderStatNode<T> NodeType;
+
+    NodeType* root;              ///< Root node of the tree
+    Alloc<NodeType> allocator;   ///< Allocation policy owning the nodes
+
+    // Helper functions for recursive tree operations
+    NodeType* insertRecursive(NodeType* node, T value);
+    NodeType* deleteRecursive(NodeType* node, T value);
+    NodeType* removeMin(NodeType* node, NodeType*& minNode);
+    NodeType* rebalance(NodeType* node);
+    NodeType* rotateLeft(NodeType* node);
+    NodeType* rotateRight(NodeType* node);
+    void update(NodeType* node);
+    T sumLess(const T& value, bool inclusive) const;
+    void deleteTree(NodeType* node);
+    NodeType* copyTree(NodeType* node);
+
+    static int heightOf(NodeType* node)  { return node ? node->height : 0; }
+    static size_t sizeOf(NodeType* node) { return node ? node->size : 0; }
+    static T totalOf(NodeType* node)     { return node ? node->total : T(); }
+
+public:
+    OrderStatBst();       ///< Constructor for OrderStatBst
+    ~OrderStatBst();      ///< Destructor for OrderStatBst
+
+    OrderStatBst(const OrderStatBst<T, Alloc>& other);                 ///< Copy constructor
+    OrderStatBst<T, Alloc>& operator=(const OrderStatBst<T, Alloc>& other);  ///< Assignment operator
+
+    void clear();                          ///< Remove every value from the tree
+    void insert(T value);                  ///< Insert a value into the tree
+    void remove(T value);                  ///< Remove one occurrence of a value from the tree
+    bool search(T value) const;            ///< Search for a value in the tree
+    size_t count() const;                  ///< Return the number of values in O(1)
+    T sum() const;                         ///< Return the sum of all values in O(1)
+    size_t rank(T value) const;            ///< Return the number of values less than a value
+    T select(size_t k) const;              ///< Return the k-th smallest value (0-based)
+    T rangeSum(T low, T high) const;       ///< Return the sum of the values in [low, high]
+    size_t rangeCount(T low, T high) const; ///< Return the number of values in [low, high]
+
+    template <class Func>
+    bool inOrder(Func func) const;         ///< In-order tree traversal with any callable
+};
+
+/**
+ * @brief Constructor for the OrderStatBst class
+ *
+ * Initializes the tree with a null root.
+ */
+template <class T, template <class> class Alloc>
+OrderStatBst<T, Alloc>::OrderStatBst()
+{
+    root = nullptr;
+}
+
+/**
+ * @brief Destructor for the OrderStatBst class
+ *
+ * Deletes the entire tree by calling the `clear` function.
+ */
+template <class T, template <class> class Alloc>
+OrderStatBst<T, Alloc>::~OrderStatBst()
+{
+    clear();
+}
+
+/**
+ * @brief Copy constructor for the OrderStatBst class
+ *
+ * Creates a deep copy of another tree, aggregates included.
+ *
+ * @param other The tree to copy from.
+ */
+template <class T, template <class> class Alloc>
+OrderStatBst<T, Alloc>::OrderStatBst(const OrderStatBst<T, Alloc>& other) : allocator()
+{
+    root = copyTree(other.root);
+}
+
+/**
+ * @brief Assignment operator for the OrderStatBst class
+ *
+ * Performs a deep copy of another tree.
+ *
+ * @param other The tree to assign from.
+ * @return A reference to the current object.
+ */
+template <class T, template <class> class Alloc>
+OrderStatBst<T, Alloc>& OrderStatBst<T, Alloc>::operator=(const OrderStatBst<T, Alloc>& other)
+{
+    if (this != &other) {
+        clear();
+        root = copyTree(other.root);
+    }
+    return *this;
+}
+
+/**
+ * @brief Remove every value from the tree
+ *
+ * Releases the nodes in bulk when the allocation policy allows it, see `Bst::clear`.
+ */
+template <class T, template <class> class Alloc>
+void OrderStatBst<T, Alloc>::clear()
+{
+    if (!Alloc<NodeType>::releasesInBulk) {
+        deleteTree(root);
+    }
+    allocator.releaseAll();
+    root = nullptr;
+}
+
+/**
+ * @brief Insert a value into the tree
+ *
+ * @param value The value to insert into the tree.
+ */
+template <class T, template <class> class Alloc>
+void OrderStatBst<T, Alloc>::insert(T value)
+{
+    root = insertRecursive(root, value);
+}
+
+/**
+ * @brief Recursive helper function to insert a value
+ *
+ * Inserts the value like `Bst` does, then refreshes the aggregates and rebalances every node
+ * on the way back up.
+ *
+ * @param node The current node in the recursive search.
+ * @param value The value to insert.
+ * @return The new root of the subtree.
+ */
+template <class T, template <class> class Alloc>
+typename OrderStatBst<T, Alloc>::NodeType* OrderStatBst<T, Alloc>::insertRecursive(NodeType* node, T value)
+{
+    if (node == nullptr)
+        return allocator.create(value);  ///< Create new node if reached empty spot
+
+    if (value < node->data)
+        node->left = insertRecursive(node->left, value);
+    else
+        node->right = insertRecursive(node->right, value);  ///< Equal values go right
+    return rebalance(node);
+}
+
+/**
+ * @brief Remove one occurrence of a value from the tree
+ *
+ * Does nothing if the value is not in the tree.
+ *
+ * @param value The value to remove from the tree.
+ */
+template <class T, template <class> class Alloc>
+void OrderStatBst<T, Alloc>::remove(T value)
+{
+    root = deleteRecursive(root, value);
+}
+
+/**
+ * @brief Recursive helper function to remove a value
+ *
+ * A node with two children is replaced by its in-order successor, which is unlinked from the
+ * right subtree rather than copied, so every node keeps its own value. Aggregates are refreshed
+ * and the subtree rebalanced on the way back up.
+ *
+ * @param node The current node being examined.
+ * @param value The value to remove.
+ * @return The new root of the subtree.
+ */
+template <class T, template <class> class Alloc>
+typename OrderStatBst<T, Alloc>::NodeType* OrderStatBst<T, Alloc>::deleteRecursive(NodeType* node, T value)
+{
+    if (node == nullptr)
+        return nullptr;  ///< Value not found
+
+    if (value < node->data) {
+        node->left = deleteRecursive(node->left, value);
+    }
+    else if (node->data < value) {
+        node->right = deleteRecursive(node->right, value);
+    }
+    else {
+        NodeType* left = node->left;
+        NodeType* right = node->right;
+        allocator.destroy(node);
+        if (right == nullptr)
+            return left;
+        NodeType* successor = nullptr;
+        right = removeMin(right, successor);
+        successor->left = left;
+        successor->right = right;
+        return rebalance(successor);
+    }
+    return rebalance(node);
+}
+
+/**
+ * @brief Unlink the smallest node of a subtree
+ *
+ * @param node The root of the subtree.
+ * @param minNode Receives the unlinked node.
+ * @return The new root of the subtree.
+ */
+template <class T, template <class> class Alloc>
+typename OrderStatBst<T, Alloc>::NodeType* OrderStatBst<T, Alloc>::removeMin(NodeType* node, NodeType*& minNode)
+{
+    if (node->left == nullptr) {
+        minNode = node;
+        return node->right;
+    }
+    node->left = removeMin(node->left, minNode);
+    return rebalance(node);
+}
+
+/**
+ * @brief Recompute the height, size and sum of a node from its children
+ *
+ * @param node The node to update.
+ */
+template <class T, template <class> class Alloc>
+void OrderStatBst<T, Alloc>::update(NodeType* node)
+{
+    int leftHeight = heightOf(node->left);
+    int rightHeight = heightOf(node->right);
+    node->height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+    node->size = 1 + sizeOf(node->left) + sizeOf(node->right);
+    node->total = node->data + totalOf(node->left) + totalOf(node->right);
+}
+
+/**
+ * @brief Restore the AVL balance of a node whose children are balanced
+ *
+ * @param node The node to rebalance.
+ * @return The new root of the subtree.
+ */
+template <class T, template <class> class Alloc>
+typename OrderStatBst<T, Alloc>::NodeType* OrderStatBst<T, Alloc>::rebalance(NodeType* node)
+{
+    update(node);
+    int balance = heightOf(node->left) - heightOf(node->right);
+    if (balance > 1) {
+        if (heightOf(node->left->left) < heightOf(node->left->right))
+            node->left = rotateLeft(node->left);    ///< Left-right case
+        return rotateRight(node);
+    }
+    if (balance < -1) {
+        if (heightOf(node->right->right) < heightOf(node->right->left))
+            node->right = rotateRight(node->right); ///< Right-left case
+        return rotateLeft(node);
+    }
+    return node;
+}
+
+/**
+ * @brief Rotate a subtree to the left, keeping the aggregates up to date
+ *
+ * @param node The root of the subtree, its right child becomes the new root.
+ * @return The new root of the subtree.
+ */
+template <class T, template <class> class Alloc>
+typename OrderStatBst<T, Alloc>::NodeType* OrderStatBst<T, Alloc>::rotateLeft(NodeType* node)
+{
+    NodeType* pivot = node->right;
+    node->right = pivot->left;
+    pivot->left = node;
+    update(node);   ///< Old root first, it is now the child
+    update(pivot);
+    return pivot;
+}
+
+/**
+ * @brief Rotate a subtree to the right, keeping the aggregates up to date
+ *
+ * @param node The root of the subtree, its left child becomes the new root.
+ * @return The new root of the subtree.
+ */
+template <class T, template <class> class Alloc>
+typename OrderStatBst<T, Alloc>::NodeType* OrderStatBst<T, Alloc>::rotateRight(NodeType* node)
+{
+    NodeType* pivot = node->left;
+    node->left = pivot->right;
+    pivot->right = node;
+    update(node);   ///< Old root first, it is now the child
+    update(pivot);
+    return pivot;
+}
+
+/**
+ * @brief Search for a value in the tree
+ *
+ * @param value The value to search for.
+ * @return `true` if the value is found, `false` otherwise.
+ */
+template <class T, template <class> class Alloc>
+bool OrderStatBst<T, Alloc>::search(T value) const
+{
+    NodeType* node = root;
+    while (node != nullptr) {
+        if (value < node->data)
+            node = node->left;
+        else if (node->data < value)
+            node = node->right;
+        else
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Count the values in the tree
+ *
+ * @return The total number of values, read from the root in O(1).
+ */
+template <class T, template <class> class Alloc>
+size_t OrderStatBst<T, Alloc>::count() const
+{
+    return sizeOf(root);
+}
+
+/**
+ * @brief Sum the values in the tree
+ *
+ * @return The sum of all values, read from the root in O(1).
+ */
+template <class T, template <class> class Alloc>
+T OrderStatBst<T, Alloc>::sum() const
+{
+    return totalOf(root);
+}
+
+/**
+ * @brief Count the values less than a given value
+ *
+ * @param value The value to rank.
+ * @return The number of values strictly less than `value`.
+ */
+template <class T, template <class> class Alloc>
+size_t OrderStatBst<T, Alloc>::rank(T value) const
+{
+    size_t result = 0;
+    NodeType* node = root;
+    while (node != nullptr) {
+        if (node->data < value) {
+            result += sizeOf(node->left) + 1;  ///< Node and its left subtree are all smaller
+            node = node->right;
+        }
+        else {
+            node = node->left;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Find the k-th smallest value
+ *
+ * `select(count() / 2)` gives the (upper) median, `select(p * (count() - 1))` the p-th quantile.
+ *
+ * @param k The 0-based position of the value in sorted order.
+ * @return The k-th smallest value.
+ * @throw std::out_of_range If `k` is not less than `count()`.
+ */
+template <class T, template <class> class Alloc>
+T OrderStatBst<T, Alloc>::select(size_t k) const
+{
+    if (k >= count())
+        throw std::out_of_range("OrderStatBst::select");
+    NodeType* node = root;
+    while (true) {
+        size_t leftSize = sizeOf(node->left);
+        if (k < leftSize) {
+            node = node->left;
+        }
+        else if (k == leftSize) {
+            return node->data;
+        }
+        else {
+            k -= leftSize + 1;
+            node = node->right;
+        }
+    }
+}
+
+/**
+ * @brief Sum the values less than (or equal to) a given value
+ *
+ * @param value The upper bound.
+ * @param inclusive Whether values equal to `value` are included.
+ * @return The sum of the values below the bound.
+ */
+template <class T, template <class> class Alloc>
+T OrderStatBst<T, Alloc>::sumLess(const T& value, bool inclusive) const
+{
+    T result = T();
+    NodeType* node = root;
+    while (node != nullptr) {
+        bool below = inclusive ? !(value < node->data) : (node->data < value);
+        if (below) {
+            result += totalOf(node->left) + node->data;  ///< Node and its left subtree are below
+            node = node->right;
+        }
+        else {
+            node = node->left;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Sum the values in a closed range
+ *
+ * @param low The smallest value to include.
+ * @param high The largest value to include.
+ * @return The sum of the values in [low, high], or the default value if the range is empty.
+ */
+template <class T, template <class> class Alloc>
+T OrderStatBst<T, Alloc>::rangeSum(T low, T high) const
+{
+    if (high < low)
+        return T();
+    return sumLess(high, true) - sumLess(low, false);
+}
+
+/**
+ * @brief Count the values in a closed range
+ *
+ * @param low The smallest value to include.
+ * @param high The largest value to include.
+ * @return The number of values in [low, high].
+ */
+template <class T, template <class> class Alloc>
+size_t OrderStatBst<T, Alloc>::rangeCount(T low, T high) const
+{
+    if (high < low)
+        return 0;
+    size_t upTo = 0;  ///< Values less than or equal to high
+    NodeType* node = root;
+    while (node != nullptr) {
+        if (!(high < node->data)) {
+            upTo += sizeOf(node->left) + 1;
+            node = node->right;
+        }
+        else {
+            node = node->left;
+        }
+    }
+    return upTo - rank(low);
+}
+
+/**
+ * @brief In-order traversal of the tree with any callable
+ *
+ * Behaves like `Bst::inOrder`: the callable may return `false` to stop early.
+ *
+ * @param func The callable to apply to each value.
+ * @return `true` if every node was visited, `false` if the callable stopped the traversal.
+ */
+template <class T, template <class> class Alloc>
+template <class Func>
+bool OrderStatBst<T, Alloc>::inOrder(Func func) const
+{
+    std::vector<NodeType*> stack;
+    NodeType* node = root;
+    while (node != nullptr || !stack.empty()) {
+        while (node != nullptr) {
+            stack.push_back(node);
+            node = node->left;
+        }
+        node = stack.back();
+        stack.pop_back();
+        if (!bstVisit(func, node->data))
+            return false;
+        node = node->right;
+    }
+    return true;
+}
+
+/**
+ * @brief Delete the entire tree recursively
+ *
+ * @param node The current node being deleted.
+ */
+template <class T, template <class> class Alloc>
+void OrderStatBst<T, Alloc>::deleteTree(NodeType* node)
+{
+    if (node != nullptr) {
+        deleteTree(node->left);
+        deleteTree(node->right);
+        allocator.destroy(node);
+    }
+}
+
+/**
+ * @brief Copy the tree recursively, aggregates included
+ *
+ * @param node The current node being copied.
+ * @return A pointer to the copy of the given node.
+ */
+template <class T, template <class> class Alloc>
+typename OrderStatBst<T, Alloc>::NodeType* OrderStatBst<T, Alloc>::copyTree(NodeType* node)
+{
+    if (node == nullptr)
+        return nullptr;
+    NodeType* newNode = allocator.create(node->data);
+    newNode->left = copyTree(node->left);
+    newNode->right = copyTree(node->right);
+    update(newNode);
+    return newNode;
+}
+
+#endif // ORDERSTATBST_H_INCLUDED
@@ -0,0 +1,425 @@
+#ifndef PERSISTENTBST_H_INCLUDED
+#define PERSISTENTBST_H_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Bst.h"
+
+/**
+ * @class PersistentNode
+ * @brief Immutable node of a `PersistentBst`
+ *
+ * Nodes are never modified once built, so any number of tree versions can share them.
+ * Children are held by reference-counted pointers: a node is reclaimed as soon as the last
+ * version that can reach it is dropped.
+ *
+ * @tparam T Type of data stored in the node (e.g., int, float).
+ */
+template <class T>
+class PersistentNode
+{
+public:
+    typedef std::shared_ptr<const PersistentNode<T> > Ptr;
+
+    const T data;            ///< Data stored in the node
+    const size_t multiplicity;  ///< Number of copies of `data` held by this node
+    const Ptr left;          ///< Left subtree
+    const Ptr right;         ///< Right subtree
+    const int height;        ///< Height of the subtree rooted here (leaf = 1)
+    const size_t size;       ///< Number of values in the subtree, copies included
+    const T total;           ///< Sum of the values in the subtree, copies included
+
+    /**
+     * @brief Constructor for PersistentNode class
+     *
+     * Builds a node on top of two existing subtrees and computes its aggregates.
+     *
+     * @param value The data to store in the node.
+     * @param copies The multiplicity of the value.
+     * @param leftChild The left subtree.
+     * @param rightChild The right subtree.
+     */
+    PersistentNode(const T& value, size_t copies, const Ptr& leftChild, const Ptr& rightChild)
+        : data(value), multiplicity(copies), left(leftChild), right(rightChild),
+          height(1 + (heightOf(leftChild) > heightOf(rightChild) ? heightOf(leftChild) : heightOf(rightChild))),
+          size(copies + sizeOf(leftChild) + sizeOf(rightChild)),
+          total(value * static_cast<T>(copies) + totalOf(leftChild) + totalOf(rightChild))
+    {
+    }
+
+    static int heightOf(const Ptr& node)  { return node ? node->height : 0; }
+    static size_t sizeOf(const Ptr& node) { return node ? node->size : 0; }
+    static T totalOf(const Ptr& node)     { return node ? node->total : T(); }
+};
+
+/**
+ * @class PersistentBst
+ * @brief Persistent (path-copying) Binary Search Tree whose readers never wait for writers
+ *
+ * This class is a variant of `Bst` that never modifies a node in place. `insert` and `remove`
+ * copy only the nodes on the path from the root to the change (plus the few nodes touched by
+ * AVL rebalancing, which keeps that path O(log n)) and then publish the new root atomically.
+ *
+ * Readers call `snapshot()` to get an immutable version of the tree, which they can search
+ * and traverse without any synchronization while ingest carries on. Taking a snapshot only
+ * loads the root from a `std::atomic<std::shared_ptr>`; the standard library may guard that
+ * load with a short internal lock, but it never waits for a writer to copy its path. Old
+ * versions are reclaimed by reference counting once the last snapshot using them is gone.
+ *
+ * Writers are serialized by an internal mutex that readers never take. Like `Bst`, the tree
+ * is a multiset that collapses equal values into one counted node.
+ *
+ * @tparam T The type of the data stored in the tree nodes (e.g., int, float).
+ */
+template <class T>
+class PersistentBst
+{
+public:
+    typedef PersistentNode<T> NodeType;
+    typedef typename NodeType::Ptr NodePtr;
+
+    /**
+     * @class Snapshot
+     * @brief Immutable version of a `PersistentBst`
+     *
+     * A snapshot keeps its version of the tree alive and can be read from any thread without
+     * locking. It is unaffected by later inserts and removes.
+     */
+    class Snapshot
+    {
+    public:
+        Snapshot() {}                                          ///< Empty snapshot
+        explicit Snapshot(const NodePtr& root) : m_root(root) {} ///< Snapshot of a given version
+
+        bool search(const T& value) const;                     ///< Search for a value
+        size_t count() const { return NodeType::sizeOf(m_root); } ///< Number of values in O(1)
+        T sum() const { return NodeType::totalOf(m_root); }    ///< Sum of all values in O(1)
+        bool isEmpty() const { return !m_root; }               ///< Check if the version is empty
+
+        template <class Func>
+        bool inOrder(Func func) const;                         ///< In-order traversal with any callable
+        template <class Func>
+        bool inOrderCounted(Func func) const;                  ///< In-order traversal with multiplicities
+
+    private:
+        NodePtr m_root;  ///< Root of this version, keeps every node of it alive
+    };
+
+    PersistentBst() {}  ///< Constructor for PersistentBst
+
+    Snapshot snapshot() const;     ///< Get the current version, readable without locking
+    void insert(const T& value);   ///< Insert a value and publish the new version
+    void remove(const T& value);   ///< Remove one copy of a value and publish the new version
+    void clear();                  ///< Publish an empty version
+    bool search(const T& value) const;  ///< Search the current version for a value
+    size_t count() const;          ///< Number of values in the current version
+    T sum() const;                 ///< Sum of the values in the current version
+
+private:
+    std::atomic<NodePtr> m_root;  ///< Current version
+    std::mutex m_writeMutex;      ///< Serializes writers, never taken by readers
+
+    PersistentBst(const PersistentBst<T>&) = delete;
+    PersistentBst<T>& operator=(const PersistentBst<T>&) = delete;
+
+    static NodePtr makeNode(const T& value, size_t copies, const NodePtr& left, const NodePtr& right);
+    static NodePtr balance(const T& value, size_t copies, const NodePtr& left, const NodePtr& right);
+    static NodePtr insertRecursive(const NodePtr& node, const T& value);
+    static NodePtr deleteRecursive(const NodePtr& node, const T& value);
+    static NodePtr removeMin(const NodePtr& node, NodePtr& minNode);
+    void publish(const NodePtr& root);
+};
+
+/**
+ * @brief Search a snapshot for a value
+ *
+ * @param value The value to search for.
+ * @return `true` if the value is in this version, `false` otherwise.
+ */
+template <class T>
+bool PersistentBst<T>::Snapshot::search(const T& value) const
+{
+    const NodeType* node = m_root.get();
+    while (node != nullptr) {
+        if (value < node->data)
+            node = node->left.get();
+        else if (value > node->data)
+            node = node->right.get();
+        else
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief In-order traversal of a snapshot with any callable
+ *
+ * Behaves like `Bst::inOrder`: each value is visited once per copy and the callable may
+ * return `false` to stop early.
+ *
+ * @param func The callable to apply to each value.
+ * @return `true` if every node was visited, `false` if the callable stopped the traversal.
+ */
+template <class T>
+template <class Func>
+bool PersistentBst<T>::Snapshot::inOrder(Func func) const
+{
+    return inOrderCounted([&func](const T& value, size_t copies) {
+        for (size_t copy = 0; copy < copies; copy++) {
+            if (!bstVisit(func, value))
+                return false;
+        }
+        return true;
+    });
+}
+
+/**
+ * @brief In-order traversal of a snapshot visiting each distinct value with its multiplicity
+ *
+ * Behaves like `Bst::inOrderCounted`.
+ *
+ * @param func The callable to apply as `func(value, multiplicity)`.
+ * @return `true` if every node was visited, `false` if the callable stopped the traversal.
+ */
+template <class T>
+template <class Func>
+bool PersistentBst<T>::Snapshot::inOrderCounted(Func func) const
+{
+    std::vector<const NodeType*> stack;  // Raw pointers are safe, m_root keeps the nodes alive
+    const NodeType* node = m_root.get();
+    while (node != nullptr || !stack.empty()) {
+        while (node != nullptr) {
+            stack.push_back(node);
+            node = node->left.get();
+        }
+        node = stack.back();
+        stack.pop_back();
+        if (!bstVisit(func, node->data, node->multiplicity))
+            return false;
+        node = node->right.get();
+    }
+    return true;
+}
+
+/**
+ * @brief Get the current version of the tree
+ *
+ * The returned snapshot can be read without locking and is not affected by later writes.
+ *
+ * @return The current version.
+ */
+template <class T>
+typename PersistentBst<T>::Snapshot PersistentBst<T>::snapshot() const
+{
+    return Snapshot(m_root.load());
+}
+
+/**
+ * @brief Insert a value and publish the new version
+ *
+ * @param value The value to insert.
+ */
+template <class T>
+void PersistentBst<T>::insert(const T& value)
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    publish(insertRecursive(m_root.load(), value));
+}
+
+/**
+ * @brief Remove one copy of a value and publish the new version
+ *
+ * Nothing is copied or published if the value is not in the tree.
+ *
+ * @param value The value to remove.
+ */
+template <class T>
+void PersistentBst<T>::remove(const T& value)
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    NodePtr current = m_root.load();
+    NodePtr updated = deleteRecursive(current, value);
+    if (updated != current)
+        publish(updated);
+}
+
+/**
+ * @brief Publish an empty version
+ *
+ * Existing snapshots keep their nodes until they are dropped.
+ */
+template <class T>
+void PersistentBst<T>::clear()
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    publish(NodePtr());
+}
+
+/**
+ * @brief Search the current version for a value
+ *
+ * @param value The value to search for.
+ * @return `true` if the value is found, `false` otherwise.
+ */
+template <class T>
+bool PersistentBst<T>::search(const T& value) const
+{
+    return snapshot().search(value);
+}
+
+/**
+ * @brief Count the values in the current version
+ *
+ * @return The number of values, copies included.
+ */
+template <class T>
+size_t PersistentBst<T>::count() const
+{
+    return snapshot().count();
+}
+
+/**
+ * @brief Sum the values in the current version
+ *
+ * @return The sum of all values, copies included.
+ */
+template <class T>
+T PersistentBst<T>::sum() const
+{
+    return snapshot().sum();
+}
+
+/**
+ * @brief Make the given tree the current version
+ *
+ * @param root The root of the new version.
+ */
+template <class T>
+void PersistentBst<T>::publish(const NodePtr& root)
+{
+    m_root.store(root);
+}
+
+template <class T>
+typename PersistentBst<T>::NodePtr PersistentBst<T>::makeNode(const T& value, size_t copies,
+                                                               const NodePtr& left, const NodePtr& right)
+{
+    return std::make_shared<const NodeType>(value, copies, left, right);
+}
+
+/**
+ * @brief Build a node over two subtrees, rotating if the AVL balance would be broken
+ *
+ * Rotations build new nodes instead of relinking existing ones, since nodes may be shared
+ * with older versions.
+ *
+ * @param value The value of the node.
+ * @param copies The multiplicity of the value.
+ * @param left The left subtree, balanced.
+ * @param right The right subtree, balanced.
+ * @return The root of the balanced subtree.
+ */
+template <class T>
+typename PersistentBst<T>::NodePtr PersistentBst<T>::balance(const T& value, size_t copies,
+                                                              const NodePtr& left, const NodePtr& right)
+{
+    int leftHeight = NodeType::heightOf(left);
+    int rightHeight = NodeType::heightOf(right);
+    if (leftHeight > rightHeight + 1) {
+        if (NodeType::heightOf(left->left) >= NodeType::heightOf(left->right)) {
+            // Single right rotation
+            return makeNode(left->data, left->multiplicity, left->left,
+                            makeNode(value, copies, left->right, right));
+        }
+        // Left-right case
+        const NodePtr& pivot = left->right;
+        return makeNode(pivot->data, pivot->multiplicity,
+                        makeNode(left->data, left->multiplicity, left->left, pivot->left),
+                        makeNode(value, copies, pivot->right, right));
+    }
+    if (rightHeight > leftHeight + 1) {
+        if (NodeType::heightOf(right->right) >= NodeType::heightOf(right->left)) {
+            // Single left rotation
+            return makeNode(right->data, right->multiplicity,
+                            makeNode(value, copies, left, right->left), right->right);
+        }
+        // Right-left case
+        const NodePtr& pivot = right->left;
+        return makeNode(pivot->data, pivot->multiplicity,
+                        makeNode(value, copies, left, pivot->left),
+                        makeNode(right->data, right->multiplicity, pivot->right, right->right));
+    }
+    return makeNode(value, copies, left, right);
+}
+
+/**
+ * @brief Recursive helper function to insert a value by path copying
+ *
+ * @param node The root of the subtree in the current version.
+ * @param value The value to insert.
+ * @return The root of the new version of the subtree.
+ */
+template <class T>
+typename PersistentBst<T>::NodePtr PersistentBst<T>::insertRecursive(const NodePtr& node, const T& value)
+{
+    if (!node)
+        return makeNode(value, 1, NodePtr(), NodePtr());
+    if (value < node->data)
+        return balance(node->data, node->multiplicity, insertRecursive(node->left, value), node->right);
+    if (value > node->data)
+        return balance(node->data, node->multiplicity, node->left, insertRecursive(node->right, value));
+    return makeNode(node->data, node->multiplicity + 1, node->left, node->right);  ///< One more copy
+}
+
+/**
+ * @brief Recursive helper function to remove a value by path copying
+ *
+ * @param node The root of the subtree in the current version.
+ * @param value The value to remove.
+ * @return The root of the new version of the subtree, or `node` itself if the value was not found.
+ */
+template <class T>
+typename PersistentBst<T>::NodePtr PersistentBst<T>::deleteRecursive(const NodePtr& node, const T& value)
+{
+    if (!node)
+        return node;  ///< Value not found
+    if (value < node->data) {
+        NodePtr left = deleteRecursive(node->left, value);
+        return (left == node->left) ? node : balance(node->data, node->multiplicity, left, node->right);
+    }
+    if (value > node->data) {
+        NodePtr right = deleteRecursive(node->right, value);
+        return (right == node->right) ? node : balance(node->data, node->multiplicity, node->left, right);
+    }
+    if (node->multiplicity > 1)
+        return makeNode(node->data, node->multiplicity - 1, node->left, node->right);
+    if (!node->left)
+        return node->right;
+    if (!node->right)
+        return node->left;
+    NodePtr successor;
+    NodePtr right = removeMin(node->right, successor);
+    return balance(successor->data, successor->multiplicity, node->left, right);
+}
+
+/**
+ * @brief Build a version of a subtree without its smallest node
+ *
+ * @param node The root of the subtree.
+ * @param minNode Receives the smallest node.
+ * @return The root of the new version of the subtree.
+ */
+template <class T>
+typename PersistentBst<T>::NodePtr PersistentBst<T>::removeMin(const NodePtr& node, NodePtr& minNode)
+{
+    if (!node->left) {
+        minNode = node;
+        return node->right;
+    }
+    return balance(node->data, node->multiplicity, removeMin(node->left, minNode), node->right);
+}
+
+#endif // PERSISTENTBST_H_INCLUDED
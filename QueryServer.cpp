@@ -0,0 +1,397 @@
+#include "QueryServer.h"
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Ids of the event sources, stored in the epoll events; connections follow
+    const uint64_t LISTEN_ID = 0;
+    const uint64_t WAKE_ID = 1;
+    const uint64_t SIGNAL_ID = 2;
+    const uint64_t FIRST_CLIENT_ID = 3;
+}
+
+QueryServer::QueryServer(Weather& weather, const string& socketPath)
+    : m_runner(weather), m_socketPath(socketPath), m_epollFd(-1), m_wakeFd(-1), m_nextClient(FIRST_CLIENT_ID),
+      m_queries(TaskScheduler::shared()), m_stopping(false)
+{
+    m_runner.setReportsAllowed(false);
+}
+
+#ifdef __linux__
+
+bool QueryServer::run()
+{
+    sockaddr_un address = {};
+    if (m_socketPath.empty() || m_socketPath.size() >= sizeof(address.sun_path))
+    {
+        cout << "Error: Invalid socket path " << m_socketPath << endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, m_socketPath.c_str(), m_socketPath.size());
+    if (!removeStaleSocket(address))
+        return false;
+
+    // The loop reads SIGINT and SIGTERM from a signalfd, so block them; scheduler workers block every signal
+    sigset_t signals, previousSignals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, &previousSignals);
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    bool started = listenFd >= 0 && signalFd >= 0 && m_wakeFd >= 0 && m_epollFd >= 0
+                   && bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0
+                   && listen(listenFd, SOMAXCONN) == 0;
+
+    const int sources[] = {listenFd, m_wakeFd, signalFd};
+    const uint64_t ids[] = {LISTEN_ID, WAKE_ID, SIGNAL_ID};
+    for (int i = 0; i < 3 && started; i++)
+    {
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = ids[i];
+        started = epoll_ctl(m_epollFd, EPOLL_CTL_ADD, sources[i], &event) == 0;
+    }
+
+    bool stoppedBySignal = false;
+    if (!started)
+        cout << "Error: Cannot listen on " << m_socketPath << ": " << std::strerror(errno) << endl;
+    else
+    {
+        m_stopping = false;
+        cout << "Listening on " << m_socketPath << " with " << TaskScheduler::shared().workerCount() << " workers"
+             << endl;
+
+        const int maxEvents = 64;
+        epoll_event events[maxEvents];
+        while (!stoppedBySignal)
+        {
+            int count = epoll_wait(m_epollFd, events, maxEvents, -1);
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                cout << "Error: Event loop failed: " << std::strerror(errno) << endl;
+                break;
+            }
+            for (int i = 0; i < count; i++)
+            {
+                uint64_t id = events[i].data.u64;
+                if (id == LISTEN_ID)
+                    acceptClients(listenFd);
+                else if (id == WAKE_ID)
+                {
+                    uint64_t wakeups;
+                    while (read(m_wakeFd, &wakeups, sizeof(wakeups)) < 0 && errno == EINTR) {}
+                    collectAnswers();
+                } else if (id == SIGNAL_ID)
+                {
+                    // Consume the signal, or it is delivered once the signal mask is restored
+                    signalfd_siginfo signal;
+                    stoppedBySignal = read(signalFd, &signal, sizeof(signal)) == sizeof(signal);
+                }
+                else if (events[i].events & (EPOLLHUP | EPOLLERR))
+                    closeClient(id);  // Gone both ways, answers could not be delivered
+                else
+                {
+                    if (events[i].events & EPOLLIN)
+                        readClient(id);
+                    if (events[i].events & EPOLLOUT)
+                        writeClient(id);
+                }
+            }
+        }
+
+        // Drop the queries not started yet and wait for the others
+        m_stopping = true;
+        try
+        {
+            m_queries.wait();
+        } catch (const std::exception& error)
+        {
+            cout << "Error: A query failed: " << error.what() << endl;
+        }
+        m_answers.clear();
+    }
+
+    while (!m_clients.empty())
+        closeClient(m_clients.begin()->first);
+    for (int fd : {listenFd, signalFd, m_wakeFd, m_epollFd})
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+    m_wakeFd = m_epollFd = -1;
+    if (started)
+        unlink(m_socketPath.c_str());
+    pthread_sigmask(SIG_SETMASK, &previousSignals, nullptr);
+    return stoppedBySignal;
+}
+
+bool QueryServer::removeStaleSocket(const sockaddr_un& address)
+{
+    struct stat status;
+    if (lstat(m_socketPath.c_str(), &status) != 0)
+    {
+        if (errno == ENOENT)
+            return true;
+        cout << "Error: Cannot check " << m_socketPath << ": " << std::strerror(errno) << endl;
+        return false;
+    }
+    if (!S_ISSOCK(status.st_mode))
+    {
+        cout << "Error: " << m_socketPath << " exists and is not a socket" << endl;
+        return false;
+    }
+
+    // A socket nobody listens on is left over from a server that did not stop cleanly
+    // Non-blocking, so a listener with a full backlog answers EAGAIN instead of stalling the start
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (probe < 0)
+    {
+        cout << "Error: Cannot check " << m_socketPath << ": " << std::strerror(errno) << endl;
+        return false;
+    }
+    bool inUse = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0
+                 || errno == EAGAIN;  // Listening, with a full backlog
+    close(probe);
+    if (inUse)
+    {
+        cout << "Error: Another server is listening on " << m_socketPath << endl;
+        return false;
+    }
+    if (unlink(m_socketPath.c_str()) != 0 && errno != ENOENT)
+    {
+        cout << "Error: Cannot remove " << m_socketPath << ": " << std::strerror(errno) << endl;
+        return false;
+    }
+    return true;
+}
+
+void QueryServer::answer(uint64_t client, uint64_t sequence, const string& query)
+{
+    if (m_stopping)
+        return;
+    ReportWriter line;
+    m_runner.answer(query, line);
+
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(m_answerMutex);
+        wake = m_answers.empty();  // Otherwise the loop has been woken and not collected yet
+        m_answers.push_back(Answer{client, sequence, line.str()});
+    }
+    if (wake)
+    {
+        uint64_t one = 1;
+        while (write(m_wakeFd, &one, sizeof(one)) < 0 && errno == EINTR) {}
+    }
+}
+
+void QueryServer::acceptClients(int listenFd)
+{
+    while (true)
+    {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            return;  // No more pending connections, or out of descriptors until some close
+        }
+
+        uint64_t id = m_nextClient++;
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            close(fd);
+            continue;
+        }
+        Client& client = m_clients[id];
+        client.fd = fd;
+        client.events = EPOLLIN;
+    }
+}
+
+void QueryServer::readClient(uint64_t id)
+{
+    std::map<uint64_t, Client>::iterator found = m_clients.find(id);
+    if (found == m_clients.end())
+        return;
+    Client& client = found->second;
+
+    char buffer[16384];
+    while (!client.closing && !isBackedUp(client))
+    {
+        ssize_t received = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (received == 0)
+            client.closing = true;  // Answer what was sent, then close
+        else if (received < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            closeClient(id);
+            return;
+        } else
+        {
+            client.input.append(buffer, received);
+            queueQueries(id, client);
+            if (client.input.size() > MAX_QUERY_LENGTH && client.input.find('\n') == string::npos)
+            {
+                closeClient(id);
+                return;
+            }
+        }
+    }
+
+    writeClient(id);  // Closes the connection if it has ended with nothing left to answer
+}
+
+bool QueryServer::isBackedUp(const Client& client)
+{
+    return client.nextSequence - client.nextToSend >= MAX_PENDING_ANSWERS
+           || client.output.size() - client.sent >= MAX_BUFFERED_OUTPUT;
+}
+
+void QueryServer::queueQueries(uint64_t id, Client& client)
+{
+    // Every complete line is one query, left in the input while the connection is backed up
+    size_t start = 0;
+    size_t end;
+    while (!isBackedUp(client) && (end = client.input.find('\n', start)) != string::npos)
+    {
+        size_t length = end - start;
+        if (length > 0 && client.input[end - 1] == '\r')
+            length--;
+        if (length > 0)
+        {
+            uint64_t sequence = client.nextSequence++;
+            string query = client.input.substr(start, length);
+            m_queries.run([this, id, sequence, query]() { answer(id, sequence, query); });
+        }
+        start = end + 1;
+    }
+    client.input.erase(0, start);
+}
+
+void QueryServer::collectAnswers()
+{
+    std::vector<Answer> answers;
+    {
+        std::lock_guard<std::mutex> lock(m_answerMutex);
+        answers.swap(m_answers);
+    }
+
+    // Queue each answer behind the earlier answers of its connection
+    std::vector<uint64_t> ready;
+    for (size_t i = 0; i < answers.size(); i++)
+    {
+        std::map<uint64_t, Client>::iterator found = m_clients.find(answers[i].client);
+        if (found == m_clients.end())
+            continue;  // The connection closed before the answer was ready
+        Client& client = found->second;
+        client.done.emplace(answers[i].sequence, std::move(answers[i].line));
+        while (!client.done.empty() && client.done.begin()->first == client.nextToSend)
+        {
+            client.output += client.done.begin()->second;
+            client.done.erase(client.done.begin());
+            client.nextToSend++;
+        }
+        ready.push_back(answers[i].client);
+    }
+
+    std::sort(ready.begin(), ready.end());
+    ready.erase(std::unique(ready.begin(), ready.end()), ready.end());
+    for (size_t i = 0; i < ready.size(); i++)
+        writeClient(ready[i]);
+}
+
+void QueryServer::writeClient(uint64_t id)
+{
+    std::map<uint64_t, Client>::iterator found = m_clients.find(id);
+    if (found == m_clients.end())
+        return;
+    Client& client = found->second;
+
+    while (client.sent < client.output.size())
+    {
+        ssize_t sent = send(client.fd, client.output.data() + client.sent, client.output.size() - client.sent,
+                            MSG_NOSIGNAL);
+        if (sent >= 0)
+            client.sent += sent;
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+        else if (errno != EINTR)
+        {
+            closeClient(id);
+            return;
+        }
+    }
+    if (client.sent == client.output.size())
+    {
+        client.output.clear();
+        client.sent = 0;
+    }
+
+    // Queries held back while the connection was backed up, the socket may have nothing new to read
+    queueQueries(id, client);
+    if (client.closing && client.output.empty() && client.nextToSend == client.nextSequence
+        && client.input.find('\n') == string::npos)
+    {
+        closeClient(id);
+        return;
+    }
+
+    // Read while the client sends and is not backed up, wait to write while answers are left over
+    uint32_t events = (client.closing || isBackedUp(client) ? 0 : EPOLLIN) | (client.output.empty() ? 0 : EPOLLOUT);
+    if (events != client.events)
+    {
+        epoll_event event = {};
+        event.events = events;
+        event.data.u64 = id;
+        epoll_ctl(m_epollFd, EPOLL_CTL_MOD, client.fd, &event);
+        client.events = events;
+    }
+}
+
+void QueryServer::closeClient(uint64_t id)
+{
+    std::map<uint64_t, Client>::iterator found = m_clients.find(id);
+    if (found == m_clients.end())
+        return;
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, found->second.fd, nullptr);
+    close(found->second.fd);
+    m_clients.erase(found);
+}
+
+#else
+
+bool QueryServer::run()
+{
+    cout << "Error: The query server needs Linux (epoll and Unix domain sockets)" << endl;
+    return false;
+}
+
+#endif // __linux__
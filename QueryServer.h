@@ -0,0 +1,115 @@
+#ifndef QUERYSERVER_H_INCLUDED
+#define QUERYSERVER_H_INCLUDED
+
+#include "BatchRunner.h"
+#include "TaskScheduler.h"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/un.h>
+#endif
+
+using std::string;
+
+/**
+ * @class QueryServer
+ * @brief Serves queries on loaded weather data over a Unix domain socket
+ *
+ * Clients connect to the socket and send queries, one per line, in the language of
+ * `BatchRunner` (e.g. `wind 3 2015`). Every query is answered with one line of JSON, the same
+ * line batch mode writes, and answers come back in the order the queries were sent, so a
+ * client may send many queries before reading. Any number of clients can be connected at once.
+ * A connection whose answers pile up, because it sends faster than it reads, is not read from
+ * until they drain below `MAX_PENDING_ANSWERS` and `MAX_BUFFERED_OUTPUT`. `report` queries are
+ * refused: clients must not create files where the server runs, and two of them could write
+ * the same report at once.
+ *
+ * One thread runs an epoll event loop that accepts connections, reads queries and writes
+ * answers without blocking. The queries themselves run as tasks of the shared `TaskScheduler`,
+ * which hand their answers back to the loop through an eventfd. The server stops on SIGINT or
+ * SIGTERM and removes its socket.
+ *
+ * The data must not be loaded while the server runs. The server is only available on Linux.
+ */
+class QueryServer
+{
+public:
+    static const size_t MAX_QUERY_LENGTH = 4096;        ///< Longest query line accepted; longer lines close the connection
+    static const size_t MAX_PENDING_ANSWERS = 1024;     ///< Queries of a connection queued or answered but not sent
+    static const size_t MAX_BUFFERED_OUTPUT = 1 << 20;  ///< Bytes of answers of a connection waiting to be sent
+
+    /**
+     * @brief Creates a server, not yet listening
+     *
+     * @param weather The loaded weather data to query.
+     * @param socketPath The path of the Unix domain socket. A socket left there by a server that
+     *                   is no longer running is replaced; anything else stops the server from starting.
+     */
+    QueryServer(Weather& weather, const string& socketPath);
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    /**
+     * @brief Serves clients until SIGINT or SIGTERM is received
+     *
+     * @return `true` if the server stopped on a signal, `false` if it could not start.
+     */
+    bool run();
+
+private:
+    /// Answer of a worker, waiting for the event loop
+    struct Answer
+    {
+        uint64_t client;    ///< Connection the query came from
+        uint64_t sequence;  ///< Position of the query among those of its connection
+        string line;        ///< JSON line answering the query
+    };
+
+    /// State of one connection
+    struct Client
+    {
+        int fd = -1;                     ///< Socket of the connection
+        string input;                    ///< Bytes received, not yet a complete query
+        uint64_t nextSequence = 0;       ///< Sequence number of the next query received
+        uint64_t nextToSend = 0;         ///< Sequence number of the next answer to send
+        std::map<uint64_t, string> done; ///< Answers waiting for an earlier one
+        string output;                   ///< Answers ready to send
+        size_t sent = 0;                 ///< Bytes of `output` already sent
+        bool closing = false;            ///< Whether to close once `output` is sent
+        uint32_t events = 0;             ///< Events epoll waits for on the socket
+    };
+
+    BatchRunner m_runner;                 ///< Parses, runs and formats queries
+    string m_socketPath;                  ///< Path of the socket
+
+    int m_epollFd;                        ///< Event loop
+    int m_wakeFd;                         ///< Signalled by workers when answers are ready
+    std::map<uint64_t, Client> m_clients; ///< Open connections, by id
+    uint64_t m_nextClient;                ///< Id of the next connection
+
+    TaskScheduler::TaskGroup m_queries;   ///< Queries being answered
+    std::atomic<bool> m_stopping;         ///< Whether queries not started yet must be dropped
+
+    std::mutex m_answerMutex;             ///< Guards `m_answers`
+    std::vector<Answer> m_answers;        ///< Answers waiting for the event loop
+
+#ifdef __linux__
+    bool removeStaleSocket(const sockaddr_un& address);
+#endif
+    void answer(uint64_t client, uint64_t sequence, const string& query);
+    void acceptClients(int listenFd);
+    void readClient(uint64_t id);
+    static bool isBackedUp(const Client& client);
+    void queueQueries(uint64_t id, Client& client);
+    void collectAnswers();
+    void writeClient(uint64_t id);
+    void closeClient(uint64_t id);
+};
+
+#endif // QUERYSERVER_H_INCLUDED
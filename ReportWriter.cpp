@@ -0,0 +1,197 @@
+#include "ReportWriter.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+ReportWriter::ReportWriter(FILE* stream)
+    : m_stream(stream), m_ownsStream(false), m_inMemory(false), m_buffer(INITIAL_SIZE), m_used(0),
+      m_fieldStart(NO_FIELD), m_failed(false)
+{
+}
+
+ReportWriter::ReportWriter(const string& filename)
+    : m_stream(std::fopen(filename.c_str(), "w")), m_ownsStream(true), m_inMemory(false), m_buffer(INITIAL_SIZE),
+      m_used(0), m_fieldStart(NO_FIELD), m_failed(false)
+{
+    if (m_stream)
+        std::setvbuf(m_stream, nullptr, _IONBF, 0);  // The writer buffers, each flush is one write
+}
+
+ReportWriter::ReportWriter()
+    : m_stream(nullptr), m_ownsStream(false), m_inMemory(true), m_buffer(256), m_used(0), m_fieldStart(NO_FIELD),
+      m_failed(false)
+{
+}
+
+ReportWriter::~ReportWriter()
+{
+    close();
+}
+
+bool ReportWriter::isOpen() const
+{
+    return m_stream != nullptr || m_inMemory;
+}
+
+string ReportWriter::str() const
+{
+    return string(m_buffer.data(), m_used);
+}
+
+bool ReportWriter::flush()
+{
+    if (m_inMemory)
+        return true;  // The text stays in the buffer until taken
+    if (m_stream == nullptr)
+    {
+        m_failed |= m_used > 0;  // Nowhere to write, the text is lost
+        m_used = 0;
+        return !m_failed && isOpen();
+    }
+    if (m_used > 0 && std::fwrite(m_buffer.data(), 1, m_used, m_stream) != m_used)
+        m_failed = true;
+    m_used = 0;
+    if (!m_ownsStream && std::fflush(m_stream) != 0)
+        m_failed = true;  // Shared stream, e.g. stdout, must be up to date before others write to it
+    return !m_failed;
+}
+
+bool ReportWriter::close()
+{
+    bool complete = flush();
+    if (m_ownsStream && m_stream && std::fclose(m_stream) != 0)
+    {
+        m_failed = true;
+        complete = false;
+    }
+    m_stream = nullptr;
+    m_ownsStream = false;
+    return complete;
+}
+
+char* ReportWriter::reserve(size_t bytes)
+{
+    if (m_used + bytes > m_buffer.size())
+    {
+        // A full-size buffer is written out. An open field is quoted in place once it ends, and text
+        // kept in memory is never written, so those stay in the buffer and it grows instead
+        if (m_buffer.size() >= BUFFER_SIZE && m_fieldStart == NO_FIELD && bytes <= m_buffer.size() && !m_inMemory)
+            flush();
+        else
+            m_buffer.resize(std::max(m_buffer.size() * 2, m_used + bytes));
+    }
+    return m_buffer.data() + m_used;
+}
+
+void ReportWriter::append(const char* text, size_t length)
+{
+    std::memcpy(reserve(length), text, length);
+    m_used += length;
+}
+
+template <class Number>
+void ReportWriter::appendNumber(Number value)
+{
+    const size_t longest = 32;  // Longest general format of a double, or of a 64-bit integer
+    char* start = reserve(longest);
+    std::to_chars_result result = std::to_chars(start, start + longest, value);
+    m_used += result.ptr - start;
+}
+
+ReportWriter& ReportWriter::operator<<(const char* value)
+{
+    append(value, std::strlen(value));
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(const string& value)
+{
+    append(value.data(), value.size());
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(char value)
+{
+    *reserve(1) = value;
+    m_used++;
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(int value)
+{
+    appendNumber(value);
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(long long value)
+{
+    appendNumber(value);
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(size_t value)
+{
+    appendNumber(value);
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(float value)
+{
+    return *this << static_cast<double>(value);  // Streams print a float as the double it converts to
+}
+
+ReportWriter& ReportWriter::operator<<(double value)
+{
+    const size_t longest = 32;
+    char* start = reserve(longest);
+    std::to_chars_result result = std::to_chars(start, start + longest, value, std::chars_format::general, 6);
+    m_used += result.ptr - start;
+    return *this;
+}
+
+void ReportWriter::beginField()
+{
+    m_fieldStart = m_used;
+}
+
+void ReportWriter::endField()
+{
+    size_t start = m_fieldStart;
+    size_t quotes = 0;
+    bool needsQuoting = false;
+    for (size_t i = start; i < m_used; i++)
+    {
+        char c = m_buffer[i];
+        quotes += (c == '"');
+        needsQuoting |= (c == ',' || c == '"' || c == '\n' || c == '\r');
+    }
+    if (!needsQuoting)
+    {
+        m_fieldStart = NO_FIELD;
+        return;
+    }
+
+    // Shift the field right, from its end, doubling every quote and wrapping it in quotes
+    size_t length = m_used - start;
+    size_t quotedLength = length + quotes + 2;
+    reserve(quotedLength - length);  // Grows the buffer, the field is still open
+    m_fieldStart = NO_FIELD;
+    char* field = m_buffer.data() + start;
+    size_t to = quotedLength - 1;
+    field[to--] = '"';
+    for (size_t from = length; from-- > 0;)
+    {
+        field[to--] = field[from];
+        if (field[from] == '"')
+            field[to--] = '"';
+    }
+    field[0] = '"';
+    m_used = start + quotedLength;
+}
+
+void ReportWriter::field(const string& text)
+{
+    beginField();
+    *this << text;
+    endField();
+}
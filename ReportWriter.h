@@ -0,0 +1,156 @@
+#ifndef REPORTWRITER_H_INCLUDED
+#define REPORTWRITER_H_INCLUDED
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using std::string;
+
+/**
+ * @class ReportWriter
+ * @brief Buffered text writer for reports and CSV files
+ *
+ * Text and numbers are appended to one large buffer, which is handed to the operating system
+ * in a single write when it fills up and when the writer is flushed or destroyed. The buffer
+ * starts small and grows only as needed, so writing a few lines costs no large allocation. Nothing is
+ * flushed per line. Numbers are formatted with `std::to_chars`, which ignores the locale and
+ * does not go through a stream; floating-point numbers use the same general format with six
+ * significant digits as `std::ostream`, so reports read exactly as before.
+ *
+ * CSV fields are written between `beginField` and `endField`. When the text of the field
+ * contains a comma, a double quote or a line break, it is quoted and its double quotes are
+ * doubled, as CSV requires.
+ *
+ * A writer created without an output keeps the text in memory, e.g. to render a result once
+ * and print it many times.
+ *
+ * Writing to `stdout` goes through the same C stream as `std::cout`, so the two can be mixed
+ * as long as the writer is flushed before `std::cout` is used again.
+ */
+class ReportWriter
+{
+public:
+    static const size_t BUFFER_SIZE = 1 << 18;  ///< Bytes collected before each write (256 KiB)
+    static const size_t INITIAL_SIZE = 1 << 12; ///< Starting size of the buffer, doubled up to `BUFFER_SIZE` as needed
+
+    /**
+     * @brief Writes to an open C stream
+     *
+     * The stream is not closed by the writer.
+     *
+     * @param stream The stream to write to, e.g. `stdout`.
+     */
+    explicit ReportWriter(FILE* stream);
+
+    /**
+     * @brief Creates or truncates a file and writes to it
+     *
+     * @param filename The name of the file.
+     */
+    explicit ReportWriter(const string& filename);
+
+    /**
+     * @brief Collects the text in memory instead of writing it
+     *
+     * The buffer grows as needed and nothing is written; the text is taken with `str`.
+     */
+    ReportWriter();
+
+    /**
+     * @brief Destructor
+     *
+     * Writes out the buffered text and closes the file if the writer opened it, as `close`
+     * does. Call `close` instead to find out whether everything was written.
+     */
+    ~ReportWriter();
+
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+
+    /**
+     * @brief Checks if the output could be opened
+     *
+     * @return `true` if the writer has a stream to write to.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Appends text or a number
+     *
+     * @param value The value to append.
+     * @return A reference to the writer, so calls can be chained.
+     */
+    ReportWriter& operator<<(const char* value);
+    ReportWriter& operator<<(const string& value);
+    ReportWriter& operator<<(char value);
+    ReportWriter& operator<<(int value);
+    ReportWriter& operator<<(long long value);
+    ReportWriter& operator<<(size_t value);
+    ReportWriter& operator<<(float value);
+    ReportWriter& operator<<(double value);
+
+    /**
+     * @brief Starts a CSV field
+     *
+     * Everything appended until `endField` is the text of one field.
+     */
+    void beginField();
+
+    /**
+     * @brief Ends a CSV field, quoting it if needed
+     */
+    void endField();
+
+    /**
+     * @brief Appends a whole CSV field
+     *
+     * @param text The text of the field, quoted if needed.
+     */
+    void field(const string& text);
+
+    /**
+     * @brief Writes out the buffered text
+     *
+     * A failed write is remembered, so later calls keep returning `false` even once writes
+     * succeed again.
+     *
+     * @return `true` if every byte appended so far was written.
+     */
+    bool flush();
+
+    /**
+     * @brief Writes out the buffered text and closes the file if the writer opened it
+     *
+     * A stream passed to the constructor is left open. Nothing can be written afterwards.
+     *
+     * @return `true` if every byte was written and the file was closed without error.
+     */
+    bool close();
+
+    /**
+     * @brief Gets the text collected by a writer created without an output
+     *
+     * @return The text appended so far.
+     */
+    string str() const;
+
+private:
+    FILE* m_stream;             ///< Destination of the text
+    bool m_ownsStream;          ///< Whether the writer closes the stream
+    bool m_inMemory;            ///< Whether the text is kept in the buffer instead of written
+    std::vector<char> m_buffer; ///< Text waiting to be written
+    size_t m_used;              ///< Number of bytes of the buffer in use
+    size_t m_fieldStart;        ///< Start of the open CSV field, `NO_FIELD` if none
+    bool m_failed;              ///< Whether a write failed, kept until the writer is destroyed
+
+    static const size_t NO_FIELD = static_cast<size_t>(-1);
+
+    char* reserve(size_t bytes);
+    void append(const char* text, size_t length);
+    template <class Number>
+    void appendNumber(Number value);
+};
+
+#endif // REPORTWRITER_H_INCLUDED
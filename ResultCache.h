@@ -0,0 +1,164 @@
+#ifndef RESULTCACHE_H_INCLUDED
+#define RESULTCACHE_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @class ResultCache
+ * @brief Least-recently-used cache of query results, tagged with the version of their data
+ *
+ * Every result is stored with the version of the data it was computed from. A lookup with a
+ * newer version treats the entry as missing and drops it, so a result is never returned once
+ * the data has changed. When the cache is full, the result used least recently is evicted.
+ *
+ * Entries are kept in a list ordered from most to least recently used, indexed by a hash map,
+ * so lookups, insertions and evictions all take constant time. A returned result stays valid
+ * until it is evicted, replaced or dropped.
+ */
+template <class Key, class Value, class Hash = std::hash<Key>>
+class ResultCache
+{
+public:
+    /**
+     * @brief Creates an empty cache
+     *
+     * @param capacity The largest number of results kept, at least one.
+     */
+    explicit ResultCache(size_t capacity);
+
+    /**
+     * @brief Looks up a result, marking it as the most recently used
+     *
+     * @param key The query.
+     * @param version The current version of the data.
+     * @return The result, or `nullptr` if it is missing or was computed from other data.
+     */
+    const Value* find(const Key& key, uint64_t version);
+
+    /**
+     * @brief Stores a result, evicting the least recently used one if the cache is full
+     *
+     * A result already stored for the same query from newer data is kept instead, so a query
+     * that finishes after a load never replaces the result of a query started after it.
+     *
+     * @param key The query.
+     * @param version The version of the data the result was computed from.
+     * @param value The result.
+     * @return The stored result, which is the one kept for the newer data.
+     */
+    const Value& insert(const Key& key, uint64_t version, Value value);
+
+    /**
+     * @brief Removes every result
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of results kept
+     *
+     * @return The number of results.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets the largest number of results kept
+     *
+     * @return The capacity of the cache.
+     */
+    size_t capacity() const;
+
+private:
+    /// One cached result
+    struct Entry
+    {
+        Key key;          ///< The query
+        uint64_t version; ///< Version of the data the result was computed from
+        Value value;      ///< The result
+    };
+
+    typedef typename std::list<Entry>::iterator EntryIterator;
+
+    std::list<Entry> m_entries;                           ///< Results, most recently used first
+    std::unordered_map<Key, EntryIterator, Hash> m_index; ///< Position of each result in `m_entries`
+    size_t m_capacity;                                    ///< Largest number of results kept
+};
+
+template <class Key, class Value, class Hash>
+ResultCache<Key, Value, Hash>::ResultCache(size_t capacity)
+    : m_capacity(capacity > 0 ? capacity : 1)
+{
+    m_index.reserve(m_capacity);
+}
+
+template <class Key, class Value, class Hash>
+const Value* ResultCache<Key, Value, Hash>::find(const Key& key, uint64_t version)
+{
+    typename std::unordered_map<Key, EntryIterator, Hash>::iterator found = m_index.find(key);
+    if (found == m_index.end())
+        return nullptr;
+
+    EntryIterator entry = found->second;
+    if (entry->version < version)
+    {
+        // Computed from data that has changed since, never return it
+        m_entries.erase(entry);
+        m_index.erase(found);
+        return nullptr;
+    }
+    if (entry->version > version)
+        return nullptr;  // Computed from data loaded after the lookup started, keep it
+    m_entries.splice(m_entries.begin(), m_entries, entry);  // Most recently used, no copy
+    return &entry->value;
+}
+
+template <class Key, class Value, class Hash>
+const Value& ResultCache<Key, Value, Hash>::insert(const Key& key, uint64_t version, Value value)
+{
+    typename std::unordered_map<Key, EntryIterator, Hash>::iterator found = m_index.find(key);
+    if (found != m_index.end())
+    {
+        EntryIterator entry = found->second;
+        if (entry->version <= version)
+        {
+            entry->version = version;
+            entry->value = std::move(value);
+        }
+        m_entries.splice(m_entries.begin(), m_entries, entry);
+        return entry->value;
+    }
+
+    if (m_entries.size() == m_capacity)
+    {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+    m_entries.push_front(Entry{key, version, std::move(value)});
+    m_index.emplace(key, m_entries.begin());
+    return m_entries.front().value;
+}
+
+template <class Key, class Value, class Hash>
+void ResultCache<Key, Value, Hash>::clear()
+{
+    m_entries.clear();
+    m_index.clear();
+}
+
+template <class Key, class Value, class Hash>
+size_t ResultCache<Key, Value, Hash>::size() const
+{
+    return m_entries.size();
+}
+
+template <class Key, class Value, class Hash>
+size_t ResultCache<Key, Value, Hash>::capacity() const
+{
+    return m_capacity;
+}
+
+#endif // RESULTCACHE_H_INCLUDED
@@ -0,0 +1,600 @@
+#ifndef SEGMENTEDVECTOR_H_INCLUDED
+#define SEGMENTEDVECTOR_H_INCLUDED
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SegmentedVector
+ * @brief A dynamic array stored in fixed-size chunks
+ *
+ * This class offers the same interface as `Vector`, but keeps its elements in separately
+ * allocated chunks of a fixed size, reached through a small chunk directory. Growing the array
+ * only ever allocates one more chunk: existing elements are never relocated, so there is no
+ * reallocation spike where the old and the new array both have to fit in memory, and peak
+ * memory while loading stays close to the final data size. Indexed access is still O(1), one
+ * shift and one mask. Chunks emptied by removals are kept for later additions until `Shrink`
+ * or `Clear` frees them, so removing and adding around a chunk boundary never reallocates.
+ *
+ * Chunks come from `Alloc`. A chunk is at most 2 MiB, so with `AlignedAllocator` a chunk of
+ * elements whose size is a power of two fills exactly one huge page.
+ *
+ * Since elements never move, references to them stay valid while elements are added.
+ *
+ * @tparam T The type of elements stored in the vector (e.g., int, double, etc.)
+ * @tparam Alloc The allocator providing the chunks. Two allocators of this type must be able to
+ *               free each other's chunks, as with `std::allocator` and `AlignedAllocator`.
+ */
+template <class T, class Alloc = std::allocator<T>>
+class SegmentedVector
+{
+    /// Largest power of two not greater than `n`, at least 1
+    static constexpr size_t floorPowerOfTwo(size_t n)
+    {
+        size_t power = 1;
+        while (power * 2 <= n)
+            power *= 2;
+        return power;
+    }
+
+    /// Number of bits in `n`, a power of two
+    static constexpr int log2(size_t n)
+    {
+        return (n <= 1) ? 0 : 1 + log2(n / 2);
+    }
+
+public:
+    static const size_t CHUNK_BYTES = 2 << 20;  ///< Target size of a chunk (2 MiB, one huge page)
+    /// Number of elements in a chunk, a power of two so indexing is a shift and a mask
+    static const size_t CHUNK_SIZE = floorPowerOfTwo(CHUNK_BYTES / sizeof(T) ? CHUNK_BYTES / sizeof(T) : 1);
+
+    template <bool IsConst>
+    class Iterator;
+    typedef Iterator<false> iterator;       ///< Read-write iterator
+    typedef Iterator<true> const_iterator;  ///< Read-only iterator
+
+    /**
+     * @brief Default constructor
+     *
+     * Initializes an empty vector, no chunk is allocated.
+     */
+    SegmentedVector();
+
+    /**
+     * @brief Constructor with specified initial capacity
+     *
+     * Allocates enough chunks to store `n` elements.
+     *
+     * @param n The initial capacity of the vector.
+     */
+    SegmentedVector(size_t n);
+
+    /**
+     * @brief Copy constructor
+     *
+     * Creates a new vector by copying the contents of another vector.
+     *
+     * @param other The vector to copy.
+     */
+    SegmentedVector(const SegmentedVector<T, Alloc>& other);
+
+    /**
+     * @brief Move constructor
+     *
+     * Takes over the chunks of another vector, which is left empty.
+     *
+     * @param other The vector to move from.
+     */
+    SegmentedVector(SegmentedVector<T, Alloc>&& other) noexcept;
+
+    /**
+     * @brief Assignment operator
+     *
+     * Assigns the contents of one vector to another.
+     *
+     * @param other The vector to assign from.
+     * @return A reference to the current vector object.
+     */
+    SegmentedVector<T, Alloc>& operator=(const SegmentedVector<T, Alloc>& other);
+
+    /**
+     * @brief Move assignment operator
+     *
+     * Frees the current elements and takes over the chunks of another vector, which is left empty.
+     *
+     * @param other The vector to move from.
+     * @return A reference to the current vector object.
+     */
+    SegmentedVector<T, Alloc>& operator=(SegmentedVector<T, Alloc>&& other) noexcept;
+
+    /**
+     * @brief Destructor
+     *
+     * Destroys the elements and frees every chunk.
+     */
+    ~SegmentedVector();
+
+    /**
+     * @brief Access element by index
+     *
+     * @param n The index of the element to access.
+     * @return A reference to the element at index `n`.
+     */
+    const T& operator[](size_t n) const;
+    T& operator[](size_t n);
+
+    /**
+     * @brief Access element at a specified index
+     *
+     * Provides bounds-checked access to an element at the specified index.
+     *
+     * @param n The index of the element to access.
+     * @return A reference to the element at the given index.
+     * @throw std::out_of_range If the index is out of bounds.
+     */
+    const T& at(size_t n) const;
+    T& at(size_t n);
+
+    /**
+     * @brief Adds an element to the end of the vector
+     *
+     * Copies or moves the element to the end of the vector, allocating a new chunk if the
+     * last one is full. No existing element is moved.
+     *
+     * @param element The element to add.
+     * @return `true` if the element was successfully added, always `true` in this implementation.
+     */
+    bool Add(const T& element);
+    bool Add(T&& element);
+
+    /**
+     * @brief Constructs an element in place at the end of the vector
+     *
+     * @param args The arguments forwarded to the element's constructor.
+     * @return A reference to the new element.
+     */
+    template <class... Args>
+    T& Emplace(Args&&... args);
+
+    /**
+     * @brief Adds slots at the end of the vector for elements constructed later with `ConstructAt`
+     *
+     * Only allocates the chunks needed and writes to none of them, so the new elements can be
+     * constructed by several threads at once, each page being first written by the thread that
+     * fills it. Every new slot must be constructed before it is read.
+     *
+     * @param count The number of slots to add.
+     */
+    void Extend(size_t count);
+
+    /**
+     * @brief Constructs an element in a slot added by `Extend`
+     *
+     * Different slots may be constructed by different threads at the same time.
+     *
+     * @param index The index of the slot.
+     * @param args The arguments forwarded to the element's constructor.
+     * @return A reference to the new element.
+     */
+    template <class... Args>
+    T& ConstructAt(size_t index, Args&&... args);
+
+    /**
+     * @brief Removes the last element from the vector
+     *
+     * A chunk left empty is kept for later additions, `Shrink` frees it.
+     *
+     * @return `true` if an element was successfully removed, `false` if the vector is empty.
+     */
+    bool Remove();
+
+    /**
+     * @brief Inserts an element at a specified index
+     *
+     * Shifts the following elements up by one position, which is O(n).
+     *
+     * @param index The index where the element should be inserted.
+     * @param element The element to insert.
+     * @return `true` if the element was successfully inserted, `false` if the index is invalid.
+     */
+    bool Insert(size_t index, T element);
+
+    /**
+     * @brief Deletes an element at a specified index
+     *
+     * Shifts the following elements down by one position, which is O(n).
+     *
+     * @param index The index of the element to delete.
+     * @return `true` if the element was successfully deleted, `false` if the index is invalid.
+     */
+    bool Delete(size_t index);
+
+    /**
+     * @brief Modifies an element at a specified index
+     *
+     * @param index The index of the element to modify.
+     * @param element The new value for the element at the given index.
+     * @return `true` if the element was successfully modified, `false` if the index is invalid.
+     */
+    bool Modify(size_t index, T element);
+
+    /**
+     * @brief Allocates chunks for a number of elements
+     *
+     * @param n The number of elements to reserve space for.
+     */
+    void Reserve(size_t n);
+
+    /**
+     * @brief Frees the chunks that hold no element
+     */
+    void Shrink();
+
+    /**
+     * @brief Removes every element and frees every chunk
+     */
+    void Clear();
+
+    /**
+     * @brief Gets the current number of elements in the vector
+     *
+     * @return The current number of elements in the vector.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets the number of elements the allocated chunks can hold
+     *
+     * @return The current capacity of the vector.
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Checks if the vector is empty
+     *
+     * @return `true` if the vector is empty, `false` otherwise.
+     */
+    bool isEmpty() const;
+
+    iterator begin();              ///< Iterator to the first element
+    iterator end();                ///< Iterator past the last element
+    const_iterator begin() const;  ///< Read-only iterator to the first element
+    const_iterator end() const;    ///< Read-only iterator past the last element
+
+private:
+    static const int CHUNK_SHIFT = log2(CHUNK_SIZE);  ///< log2(CHUNK_SIZE)
+    static const size_t CHUNK_MASK = CHUNK_SIZE - 1;  ///< Offset of an index within its chunk
+
+    std::vector<T*> m_chunks;  ///< Chunk directory, every chunk holds CHUNK_SIZE slots
+    size_t m_size;             ///< Number of elements stored
+    Alloc m_allocator;         ///< Source of the chunks
+
+    T* slot(size_t n) const
+    {
+        return m_chunks[n >> CHUNK_SHIFT] + (n & CHUNK_MASK);
+    }
+
+    T* nextSlot();
+    void addChunk();
+    void freeChunksAfter(size_t used);
+};
+
+/**
+ * @class SegmentedVector::Iterator
+ * @brief Random-access iterator over a `SegmentedVector`
+ *
+ * @tparam IsConst Whether the iterator gives read-only access.
+ */
+template <class T, class Alloc>
+template <bool IsConst>
+class SegmentedVector<T, Alloc>::Iterator
+{
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef typename std::conditional<IsConst, const T*, T*>::type pointer;
+    typedef typename std::conditional<IsConst, const T&, T&>::type reference;
+    typedef typename std::conditional<IsConst, const SegmentedVector<T, Alloc>*, SegmentedVector<T, Alloc>*>::type Owner;
+
+    Iterator() : m_owner(nullptr), m_index(0) {}
+    Iterator(Owner owner, size_t index) : m_owner(owner), m_index(index) {}
+    operator Iterator<true>() const { return Iterator<true>(m_owner, m_index); }  ///< Read-write to read-only
+
+    reference operator*() const { return (*m_owner)[m_index]; }
+    pointer operator->() const { return &(*m_owner)[m_index]; }
+    reference operator[](difference_type n) const { return (*m_owner)[m_index + n]; }
+
+    Iterator& operator++() { ++m_index; return *this; }
+    Iterator& operator--() { --m_index; return *this; }
+    Iterator operator++(int) { Iterator previous = *this; ++m_index; return previous; }
+    Iterator operator--(int) { Iterator previous = *this; --m_index; return previous; }
+    Iterator& operator+=(difference_type n) { m_index += n; return *this; }
+    Iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+    Iterator operator+(difference_type n) const { return Iterator(m_owner, m_index + n); }
+    Iterator operator-(difference_type n) const { return Iterator(m_owner, m_index - n); }
+    friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+    difference_type operator-(const Iterator& other) const
+    {
+        return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+    }
+
+    bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+    bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+    bool operator<(const Iterator& other) const { return m_index < other.m_index; }
+    bool operator>(const Iterator& other) const { return m_index > other.m_index; }
+    bool operator<=(const Iterator& other) const { return m_index <= other.m_index; }
+    bool operator>=(const Iterator& other) const { return m_index >= other.m_index; }
+
+private:
+    Owner m_owner;    ///< Vector being iterated
+    size_t m_index;   ///< Position in the vector
+};
+
+template <class T, class Alloc>
+SegmentedVector<T, Alloc>::SegmentedVector() : m_size(0) {}
+
+template <class T, class Alloc>
+SegmentedVector<T, Alloc>::SegmentedVector(size_t n) : m_size(0)
+{
+    Reserve(n);
+}
+
+template <class T, class Alloc>
+SegmentedVector<T, Alloc>::SegmentedVector(const SegmentedVector<T, Alloc>& other) : m_size(0)
+{
+    Reserve(other.m_size);
+    for (size_t i = 0; i < other.m_size; i++)
+        Add(other[i]);
+}
+
+template <class T, class Alloc>
+SegmentedVector<T, Alloc>::SegmentedVector(SegmentedVector<T, Alloc>&& other) noexcept
+    : m_chunks(std::move(other.m_chunks)), m_size(other.m_size), m_allocator(std::move(other.m_allocator))
+{
+    other.m_chunks.clear();
+    other.m_size = 0;
+}
+
+template <class T, class Alloc>
+SegmentedVector<T, Alloc>& SegmentedVector<T, Alloc>::operator=(const SegmentedVector<T, Alloc>& other)
+{
+    if (this != &other)
+    {
+        Clear();
+        Reserve(other.m_size);
+        for (size_t i = 0; i < other.m_size; i++)
+            Add(other[i]);
+    }
+    return *this;
+}
+
+template <class T, class Alloc>
+SegmentedVector<T, Alloc>& SegmentedVector<T, Alloc>::operator=(SegmentedVector<T, Alloc>&& other) noexcept
+{
+    if (this != &other)
+    {
+        Clear();
+        m_chunks.swap(other.m_chunks);
+        m_size = other.m_size;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+template <class T, class Alloc>
+SegmentedVector<T, Alloc>::~SegmentedVector()
+{
+    Clear();
+}
+
+template <class T, class Alloc>
+const T& SegmentedVector<T, Alloc>::operator[](size_t n) const
+{
+    return *slot(n);
+}
+
+template <class T, class Alloc>
+T& SegmentedVector<T, Alloc>::operator[](size_t n)
+{
+    return *slot(n);
+}
+
+template <class T, class Alloc>
+const T& SegmentedVector<T, Alloc>::at(size_t n) const
+{
+    if (n >= m_size)
+        throw std::out_of_range("SegmentedVector::at");
+    return *slot(n);
+}
+
+template <class T, class Alloc>
+T& SegmentedVector<T, Alloc>::at(size_t n)
+{
+    if (n >= m_size)
+        throw std::out_of_range("SegmentedVector::at");
+    return *slot(n);
+}
+
+template <class T, class Alloc>
+T* SegmentedVector<T, Alloc>::nextSlot()
+{
+    if ((m_size >> CHUNK_SHIFT) == m_chunks.size())
+        addChunk();  // Last chunk is full, existing elements stay where they are
+    return slot(m_size);
+}
+
+template <class T, class Alloc>
+void SegmentedVector<T, Alloc>::addChunk()
+{
+    m_chunks.reserve(m_chunks.size() + 1);
+    m_chunks.push_back(std::allocator_traits<Alloc>::allocate(m_allocator, CHUNK_SIZE));
+}
+
+template <class T, class Alloc>
+bool SegmentedVector<T, Alloc>::Add(const T& element)
+{
+    new (nextSlot()) T(element);
+    m_size++;
+    return true;
+}
+
+template <class T, class Alloc>
+bool SegmentedVector<T, Alloc>::Add(T&& element)
+{
+    new (nextSlot()) T(std::move(element));
+    m_size++;
+    return true;
+}
+
+template <class T, class Alloc>
+template <class... Args>
+T& SegmentedVector<T, Alloc>::Emplace(Args&&... args)
+{
+    T* element = new (nextSlot()) T(std::forward<Args>(args)...);
+    m_size++;
+    return *element;
+}
+
+template <class T, class Alloc>
+void SegmentedVector<T, Alloc>::Extend(size_t count)
+{
+    static_assert(std::is_trivially_destructible<T>::value, "a slot not constructed yet must be safe to destroy");
+    Reserve(m_size + count);
+    m_size += count;
+}
+
+template <class T, class Alloc>
+template <class... Args>
+T& SegmentedVector<T, Alloc>::ConstructAt(size_t index, Args&&... args)
+{
+    return *new (slot(index)) T(std::forward<Args>(args)...);
+}
+
+template <class T, class Alloc>
+bool SegmentedVector<T, Alloc>::Remove()
+{
+    if (m_size == 0)
+        return false;  // No element to remove
+    slot(--m_size)->~T();
+    return true;
+}
+
+template <class T, class Alloc>
+bool SegmentedVector<T, Alloc>::Insert(size_t index, T element)
+{
+    if (index > m_size)
+        return false;  // Invalid index
+    if (index == m_size)
+        return Add(std::move(element));
+    Add(std::move((*this)[m_size - 1]));  // Last element moves up into a new slot
+    for (size_t i = m_size - 2; i > index; i--)
+        (*this)[i] = std::move((*this)[i - 1]);
+    (*this)[index] = std::move(element);
+    return true;
+}
+
+template <class T, class Alloc>
+bool SegmentedVector<T, Alloc>::Delete(size_t index)
+{
+    if (index >= m_size)
+        return false;  // Invalid index
+    for (size_t i = index + 1; i < m_size; i++)
+        (*this)[i - 1] = std::move((*this)[i]);
+    return Remove();
+}
+
+template <class T, class Alloc>
+bool SegmentedVector<T, Alloc>::Modify(size_t index, T element)
+{
+    if (index >= m_size)
+        return false;  // Invalid index
+    (*this)[index] = std::move(element);
+    return true;
+}
+
+template <class T, class Alloc>
+void SegmentedVector<T, Alloc>::Reserve(size_t n)
+{
+    size_t chunks = (n + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    m_chunks.reserve(chunks);
+    while (m_chunks.size() < chunks)
+        addChunk();
+}
+
+template <class T, class Alloc>
+void SegmentedVector<T, Alloc>::Shrink()
+{
+    freeChunksAfter(m_size);
+    m_chunks.shrink_to_fit();
+}
+
+template <class T, class Alloc>
+void SegmentedVector<T, Alloc>::Clear()
+{
+    for (size_t i = 0; i < m_size; i++)
+        slot(i)->~T();
+    m_size = 0;
+    freeChunksAfter(0);
+}
+
+template <class T, class Alloc>
+void SegmentedVector<T, Alloc>::freeChunksAfter(size_t used)
+{
+    size_t needed = (used + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    while (m_chunks.size() > needed)
+    {
+        std::allocator_traits<Alloc>::deallocate(m_allocator, m_chunks.back(), CHUNK_SIZE);
+        m_chunks.pop_back();
+    }
+}
+
+template <class T, class Alloc>
+size_t SegmentedVector<T, Alloc>::size() const
+{
+    return m_size;
+}
+
+template <class T, class Alloc>
+size_t SegmentedVector<T, Alloc>::capacity() const
+{
+    return m_chunks.size() * CHUNK_SIZE;
+}
+
+template <class T, class Alloc>
+bool SegmentedVector<T, Alloc>::isEmpty() const
+{
+    return m_size == 0;
+}
+
+template <class T, class Alloc>
+typename SegmentedVector<T, Alloc>::iterator SegmentedVector<T, Alloc>::begin()
+{
+    return iterator(this, 0);
+}
+
+template <class T, class Alloc>
+typename SegmentedVector<T, Alloc>::iterator SegmentedVector<T, Alloc>::end()
+{
+    return iterator(this, m_size);
+}
+
+template <class T, class Alloc>
+typename SegmentedVector<T, Alloc>::const_iterator SegmentedVector<T, Alloc>::begin() const
+{
+    return const_iterator(this, 0);
+}
+
+template <class T, class Alloc>
+typename SegmentedVector<T, Alloc>::const_iterator SegmentedVector<T, Alloc>::end() const
+{
+    return const_iterator(this, m_size);
+}
+
+#endif // SEGMENTEDVECTOR_H_INCLUDED
@@ -0,0 +1,81 @@
+#ifndef SPSCRING_H_INCLUDED
+#define SPSCRING_H_INCLUDED
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class SpscRing
+ * @brief Lock-free ring buffer passing values from one producer thread to one consumer thread
+ *
+ * The producer only writes the tail index and the consumer only writes the head index, so no
+ * lock and no read-modify-write instruction is needed: each side publishes its progress with a
+ * release store and sees the other's with an acquire load. Each index sits on its own cache
+ * line, with a cached copy of the other side's index, so the two threads do not keep stealing
+ * a line from each other while the ring is neither full nor empty.
+ *
+ * Exactly one thread may call `tryPush` and exactly one other thread may call `tryPop`.
+ */
+template <class T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscRing() : m_head(0), m_cachedTail(0), m_tail(0), m_cachedHead(0) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Adds a value at the back, called by the producer only
+     *
+     * @param value The value to add.
+     * @return `true` if it was added, `false` if the ring is full.
+     */
+    bool tryPush(const T& value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity)
+                return false;
+        }
+        m_slots[tail & (Capacity - 1)] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the value at the front, called by the consumer only
+     *
+     * @param value Receives the value.
+     * @return `true` if a value was removed, `false` if the ring is empty.
+     */
+    bool tryPop(T& value)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+                return false;
+        }
+        value = m_slots[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static const size_t CACHE_LINE = 64;  ///< Size of a cache line
+
+    alignas(CACHE_LINE) std::atomic<size_t> m_head;      ///< Number of values popped, written by the consumer
+    size_t m_cachedTail;                                 ///< Consumer's last view of `m_tail`
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail;      ///< Number of values pushed, written by the producer
+    size_t m_cachedHead;                                 ///< Producer's last view of `m_head`
+    alignas(CACHE_LINE) std::array<T, Capacity> m_slots; ///< Values, indexed modulo the capacity
+};
+
+#endif // SPSCRING_H_INCLUDED
@@ -0,0 +1,215 @@
+#include "TaskScheduler.h"
+#include "BackOff.h"
+
+#ifdef __linux__
+#include <csignal>
+#include <pthread.h>
+#endif
+
+namespace
+{
+    // Scheduler the current thread works for, and the index of its queue
+    thread_local const TaskScheduler* t_scheduler = nullptr;
+    thread_local size_t t_queue = 0;
+
+    std::atomic<size_t> g_sharedWorkerCount(0);
+}
+
+TaskScheduler::TaskScheduler(size_t workerCount)
+    : m_workerCount(workerCount > 0 ? workerCount : std::max(2u, std::thread::hardware_concurrency()) - 1),
+      m_queues(new Queue[m_workerCount + 1]), m_queued(0), m_sleeping(0), m_stopping(false)
+{
+    for (size_t w = 0; w < m_workerCount; w++)
+        m_workers.emplace_back(&TaskScheduler::work, this, w);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (size_t w = 0; w < m_workers.size(); w++)
+        m_workers[w].join();
+}
+
+TaskScheduler& TaskScheduler::shared()
+{
+    static TaskScheduler scheduler(g_sharedWorkerCount.load());
+    return scheduler;
+}
+
+void TaskScheduler::setSharedWorkerCount(size_t workerCount)
+{
+    g_sharedWorkerCount.store(workerCount);
+}
+
+size_t TaskScheduler::workerCount() const
+{
+    return m_workerCount;
+}
+
+size_t TaskScheduler::queueOfThisThread() const
+{
+    return t_scheduler == this ? t_queue : m_workerCount;  // Other threads share the last queue
+}
+
+void TaskScheduler::push(Task task)
+{
+    Queue& queue = m_queues[queueOfThisThread()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    // A worker going to sleep counts itself before checking m_queued, so one of the two sees the other
+    m_queued.fetch_add(1);
+    if (m_sleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_wake.notify_one();
+    }
+}
+
+bool TaskScheduler::takeTask(Task& task)
+{
+    size_t own = queueOfThisThread();
+    {
+        Queue& queue = m_queues[own];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());  // Newest first, its data is likely still cached
+            queue.tasks.pop_back();
+            m_queued.fetch_sub(1);
+            return true;
+        }
+    }
+    if (m_queued.load() == 0)
+        return false;
+
+    // Steal the older half of another queue, starting with the next one so thieves spread out
+    std::vector<Task> stolen;
+    size_t queueCount = m_workerCount + 1;
+    for (size_t i = 1; i < queueCount && stolen.empty(); i++)
+    {
+        Queue& victim = m_queues[(own + i) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        size_t count = own < m_workerCount ? (victim.tasks.size() + 1) / 2 : std::min<size_t>(victim.tasks.size(), 1);
+        for (size_t t = 0; t < count; t++)
+        {
+            stolen.push_back(std::move(victim.tasks.front()));
+            victim.tasks.pop_front();
+        }
+    }
+    if (stolen.empty())
+        return false;
+
+    task = std::move(stolen.front());
+    m_queued.fetch_sub(1);
+    if (stolen.size() > 1)
+    {
+        Queue& queue = m_queues[own];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (size_t t = stolen.size() - 1; t > 0; t--)
+            queue.tasks.push_back(std::move(stolen[t]));  // Oldest at the back, it runs next
+    }
+    return true;
+}
+
+void TaskScheduler::execute(Task& task)
+{
+    std::exception_ptr error;
+    try
+    {
+        task.run();
+    } catch (...)
+    {
+        error = std::current_exception();
+    }
+    task.group->finish(error);
+}
+
+void TaskScheduler::work(size_t index)
+{
+    t_scheduler = this;
+    t_queue = index;
+#ifdef __linux__
+    // Leave signals such as SIGINT to the threads that expect them, e.g. through a signalfd
+    sigset_t signals;
+    sigfillset(&signals);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+#endif
+    while (true)
+    {
+        Task task;
+        if (takeTask(task))
+        {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleeping.fetch_add(1);
+        m_wake.wait(lock, [this]() { return m_stopping || m_queued.load() > 0; });
+        m_sleeping.fetch_sub(1);
+        if (m_stopping)
+            return;
+    }
+}
+
+TaskScheduler::TaskGroup::TaskGroup(TaskScheduler& scheduler)
+    : m_scheduler(scheduler), m_pending(0)
+{
+}
+
+TaskScheduler::TaskGroup::~TaskGroup()
+{
+    waitAll();
+}
+
+void TaskScheduler::TaskGroup::run(std::function<void()> task)
+{
+    m_pending.fetch_add(1);
+    m_scheduler.push(Task{std::move(task), this});
+}
+
+void TaskScheduler::TaskGroup::wait()
+{
+    waitAll();
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        error = m_error;
+        m_error = nullptr;
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void TaskScheduler::TaskGroup::waitAll()
+{
+    unsigned attempts = 0;
+    while (m_pending.load(std::memory_order_acquire) > 0)
+    {
+        Task task;
+        if (m_scheduler.takeTask(task))
+        {
+            m_scheduler.execute(task);  // Any queued task, the group's own are likely among them
+            attempts = 0;
+        } else
+            backOff(attempts);  // The remaining tasks run on other threads
+    }
+}
+
+void TaskScheduler::TaskGroup::finish(std::exception_ptr error)
+{
+    if (error)
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        if (!m_error)
+            m_error = error;
+    }
+    m_pending.fetch_sub(1, std::memory_order_release);  // Last use, the waiting thread may destroy the group
+}
@@ -0,0 +1,195 @@
+#ifndef TASKSCHEDULER_H_INCLUDED
+#define TASKSCHEDULER_H_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class TaskScheduler
+ * @brief Work-stealing thread pool running fork-join tasks
+ *
+ * Every worker thread has its own queue of tasks. A worker adds the tasks it creates to the
+ * back of its queue and takes its next task from the back too, so it keeps working on data
+ * still in its cache. A worker whose queue is empty steals half of the tasks at the front of
+ * another queue, the oldest and usually largest ones, so the load evens out when some tasks
+ * take far longer than others. Idle workers sleep until a task is added.
+ *
+ * Tasks are started through a `TaskGroup` or `parallelFor`, and a thread waiting for them
+ * runs queued tasks meanwhile, so tasks may start and wait for tasks of their own.
+ */
+class TaskScheduler
+{
+public:
+    class TaskGroup;
+
+    /**
+     * @brief Starts the worker threads
+     *
+     * @param workerCount The number of worker threads, 0 for one less than the hardware threads
+     *                    (at least one), leaving a core to the thread that waits for the tasks.
+     */
+    explicit TaskScheduler(size_t workerCount);
+
+    /**
+     * @brief Destructor
+     *
+     * Stops the worker threads. No task may be left to run.
+     */
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+     * @brief Gets the scheduler shared by the whole program, started on first use
+     *
+     * @return The shared scheduler.
+     */
+    static TaskScheduler& shared();
+
+    /**
+     * @brief Sets the number of worker threads of the shared scheduler
+     *
+     * Only has an effect before the shared scheduler is first used.
+     *
+     * @param workerCount The number of worker threads, 0 for the default.
+     */
+    static void setSharedWorkerCount(size_t workerCount);
+
+    /**
+     * @brief Gets the number of worker threads
+     *
+     * @return The number of worker threads.
+     */
+    size_t workerCount() const;
+
+    /**
+     * @brief Runs a function over a range of indices, split into tasks
+     *
+     * The range is cut into slices of at least `grain` indices, a few per thread so that stealing
+     * can even out slow slices. The calling thread runs the first slice, then helps with the
+     * others until all are done. An exception thrown by a slice is rethrown once all are done.
+     *
+     * @param begin The first index.
+     * @param end The index past the last one.
+     * @param grain The smallest number of indices worth a task of its own.
+     * @param body Called as `body(size_t first, size_t last)` for each slice `[first, last)`.
+     */
+    template <class Body>
+    void parallelFor(size_t begin, size_t end, size_t grain, Body body);
+
+private:
+    /// Task waiting to run
+    struct Task
+    {
+        std::function<void()> run;  ///< Work to do
+        TaskGroup* group;           ///< Group told when the task is done
+    };
+
+    /// Queue of one worker, on its own cache lines
+    struct alignas(64) Queue
+    {
+        std::mutex mutex;        ///< Guards `tasks`
+        std::deque<Task> tasks;  ///< Tasks, the newest at the back
+    };
+
+    size_t m_workerCount;                  ///< Number of worker threads
+    std::unique_ptr<Queue[]> m_queues;     ///< One queue per worker, then one for every other thread
+    std::vector<std::thread> m_workers;    ///< Worker threads
+
+    std::atomic<size_t> m_queued;          ///< Number of tasks in all the queues
+    std::atomic<size_t> m_sleeping;        ///< Number of workers waiting for a task
+    std::mutex m_sleepMutex;               ///< Guards the sleep of the workers and `m_stopping`
+    std::condition_variable m_wake;        ///< Signalled when a task is added or the workers must exit
+    bool m_stopping;                       ///< Whether the workers must exit
+
+    void push(Task task);
+    bool takeTask(Task& task);
+    void execute(Task& task);
+    void work(size_t index);
+    size_t queueOfThisThread() const;
+};
+
+/**
+ * @class TaskScheduler::TaskGroup
+ * @brief Set of tasks that can be waited for together
+ */
+class TaskScheduler::TaskGroup
+{
+public:
+    /**
+     * @brief Creates an empty group
+     *
+     * @param scheduler The scheduler running the tasks.
+     */
+    explicit TaskGroup(TaskScheduler& scheduler);
+
+    /**
+     * @brief Destructor, waits for the tasks still running and ignores their exceptions
+     */
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * @brief Queues a task
+     *
+     * @param task The function to run.
+     */
+    void run(std::function<void()> task);
+
+    /**
+     * @brief Runs queued tasks until every task of the group is done
+     *
+     * Rethrows the first exception thrown by a task of the group, if any.
+     */
+    void wait();
+
+private:
+    friend class TaskScheduler;
+
+    TaskScheduler& m_scheduler;    ///< Scheduler running the tasks
+    std::atomic<size_t> m_pending; ///< Number of tasks not done yet
+    std::mutex m_errorMutex;       ///< Guards `m_error`
+    std::exception_ptr m_error;    ///< First exception thrown by a task
+
+    void finish(std::exception_ptr error);
+    void waitAll();
+};
+
+template <class Body>
+void TaskScheduler::parallelFor(size_t begin, size_t end, size_t grain, Body body)
+{
+    if (begin >= end)
+        return;
+    size_t count = end - begin;
+    size_t slices = std::min((count + grain - 1) / std::max<size_t>(grain, 1), (m_workerCount + 1) * 4);
+    if (slices <= 1)
+    {
+        body(begin, end);
+        return;
+    }
+
+    TaskGroup group(*this);
+    for (size_t s = 1; s < slices; s++)
+    {
+        group.run([&body, begin, count, slices, s]()
+        {
+            body(begin + count * s / slices, begin + count * (s + 1) / slices);
+        });
+    }
+    body(begin, begin + count / slices);
+    group.wait();
+}
+
+#endif // TASKSCHEDULER_H_INCLUDED
@@ -0,0 +1,450 @@
+#include "EytzingerTree.h"
+#include "OrderStatBst.h"
+#include "BPlusTree.h"
+#include "PersistentBst.h"
+#include "MapBackend.h"
+#include <atomic>
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::vector;
+
+namespace
+{
+    int g_failures = 0;
+
+    /**
+     * @brief Reports a failed check
+     *
+     * @param passed Whether the check passed.
+     * @param what Description of the check.
+     */
+    void check(bool passed, const char* what)
+    {
+        if (!passed)
+        {
+            cout << "FAILED: " << what << endl;
+            g_failures++;
+        }
+    }
+
+    /**
+     * @brief Counts the values of a sorted vector that are less than a value
+     *
+     * @param sorted The values, in ascending order.
+     * @param value The value to rank.
+     * @return The number of values less than `value`.
+     */
+    template <class T>
+    size_t rankIn(const vector<T>& sorted, const T& value)
+    {
+        return std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin();
+    }
+
+    /**
+     * @brief Removes one copy of a value from a sorted vector
+     *
+     * @param sorted The values, in ascending order.
+     * @param value The value to remove.
+     */
+    template <class T>
+    void eraseOne(vector<T>& sorted, const T& value)
+    {
+        typename vector<T>::iterator found = std::lower_bound(sorted.begin(), sorted.end(), value);
+        if (found != sorted.end() && *found == value)
+            sorted.erase(found);
+    }
+
+    /**
+     * @brief Collects the values of a tree in traversal order
+     *
+     * @param tree Any tree with an `inOrder` traversal.
+     * @return The values, one entry per copy.
+     */
+    template <class Tree>
+    vector<int> valuesOf(const Tree& tree)
+    {
+        vector<int> values;
+        tree.inOrder([&values](const int& value) { values.push_back(value); });
+        return values;
+    }
+
+    /**
+     * @brief Checks `EytzingerTree` lookups against a sorted vector
+     *
+     * Covers duplicates, values outside the stored range and every tree size up to a few
+     * complete levels, so both the left and right edges of the implicit tree are reached.
+     */
+    void testEytzingerTree()
+    {
+        std::mt19937 random(28);
+        for (size_t size = 0; size <= 70; size++)
+        {
+            vector<int> sorted(size);
+            for (size_t i = 0; i < size; i++)
+                sorted[i] = static_cast<int>(random() % 40) - 20;
+            std::sort(sorted.begin(), sorted.end());
+
+            EytzingerTree<int> tree(sorted.begin(), sorted.end());
+            check(tree.size() == size, "EytzingerTree::size() matches the input");
+            check(tree.isEmpty() == (size == 0), "EytzingerTree::isEmpty()");
+            for (int value = -25; value <= 25; value++)
+            {
+                size_t rank = rankIn(sorted, value);
+                const int* lower = tree.lowerBound(value);
+                check(tree.rank(value) == rank, "EytzingerTree::rank() counts the smaller values");
+                check(tree.search(value) == std::binary_search(sorted.begin(), sorted.end(), value),
+                      "EytzingerTree::search()");
+                check(rank == size ? lower == nullptr : (lower != nullptr && *lower == sorted[rank]),
+                      "EytzingerTree::lowerBound() finds the first value not less");
+            }
+
+            EytzingerTree<int> copy(tree);
+            check(copy.size() == size && (size == 0 || copy.rank(sorted.back()) == tree.rank(sorted.back())),
+                  "EytzingerTree copy answers like the original");
+        }
+
+        vector<float> readings = { -3.5f, 0.0f, 0.25f, 0.25f, 12.0f };
+        EytzingerTree<float> floats(readings.begin(), readings.end());
+        check(floats.rank(0.25f) == 2 && floats.rank(100.0f) == 5 && floats.rank(-10.0f) == 0,
+              "EytzingerTree<float>::rank()");
+    }
+
+    /**
+     * @brief Checks `OrderStatBst` against a sorted vector under random inserts and removes
+     */
+    void testOrderStatBst()
+    {
+        std::mt19937 random(29);
+        OrderStatBst<int> tree;
+        vector<int> sorted;
+        for (int step = 0; step < 20000; step++)
+        {
+            int value = static_cast<int>(random() % 200) - 100;
+            if (random() % 3 == 0)
+            {
+                tree.remove(value);
+                eraseOne(sorted, value);
+            } else
+            {
+                tree.insert(value);
+                sorted.insert(sorted.begin() + rankIn(sorted, value + 1), value);
+            }
+
+            if (step % 97 != 0)
+                continue;
+            long long total = 0;
+            for (size_t i = 0; i < sorted.size(); i++)
+                total += sorted[i];
+            check(tree.count() == sorted.size(), "OrderStatBst::count()");
+            check(tree.sum() == total, "OrderStatBst::sum()");
+            check(valuesOf(tree) == sorted, "OrderStatBst::inOrder() visits the values in order");
+            for (int probe = -105; probe <= 105; probe += 7)
+            {
+                check(tree.rank(probe) == rankIn(sorted, probe), "OrderStatBst::rank()");
+                check(tree.search(probe) == std::binary_search(sorted.begin(), sorted.end(), probe),
+                      "OrderStatBst::search()");
+                int high = probe + 30;
+                size_t first = rankIn(sorted, probe);
+                size_t last = rankIn(sorted, high + 1);
+                int rangeTotal = 0;
+                for (size_t i = first; i < last; i++)
+                    rangeTotal += sorted[i];
+                check(tree.rangeCount(probe, high) == last - first, "OrderStatBst::rangeCount()");
+                check(tree.rangeSum(probe, high) == rangeTotal, "OrderStatBst::rangeSum()");
+            }
+            for (size_t k = 0; k < sorted.size(); k += 1 + sorted.size() / 16)
+                check(tree.select(k) == sorted[k], "OrderStatBst::select()");
+        }
+
+        OrderStatBst<int> copy(tree);
+        tree.clear();
+        check(tree.count() == 0 && copy.count() == sorted.size(), "OrderStatBst copy is independent");
+        check(valuesOf(copy) == sorted, "OrderStatBst copy keeps the values");
+
+        bool thrown = false;
+        try
+        {
+            copy.select(copy.count());
+        } catch (const std::out_of_range&)
+        {
+            thrown = true;
+        }
+        check(thrown, "OrderStatBst::select() past the end throws");
+    }
+
+    /**
+     * @brief Checks `BPlusTree` against a sorted vector under random inserts and removes
+     *
+     * Enough distinct values are used to split and merge nodes on several levels.
+     */
+    void testBPlusTree()
+    {
+        std::mt19937 random(33);
+        BPlusTree<int> tree;
+        vector<int> sorted;
+        for (int step = 0; step < 60000; step++)
+        {
+            int value = static_cast<int>(random() % 5000) - 2500;
+            if (step > 30000 && random() % 2 == 0)
+            {
+                tree.remove(value);
+                eraseOne(sorted, value);
+            } else
+            {
+                tree.insert(value);
+                sorted.insert(sorted.begin() + rankIn(sorted, value + 1), value);
+            }
+
+            if (step % 997 != 0)
+                continue;
+            int total = 0;
+            for (size_t i = 0; i < sorted.size(); i++)
+                total += sorted[i];
+            check(tree.count() == sorted.size(), "BPlusTree::count()");
+            check(tree.sum() == total, "BPlusTree::sum()");
+            check(valuesOf(tree) == sorted, "BPlusTree::inOrder() visits the values in order");
+            for (int probe = -2600; probe <= 2600; probe += 37)
+                check(tree.search(probe) == std::binary_search(sorted.begin(), sorted.end(), probe),
+                      "BPlusTree::search()");
+        }
+
+        size_t counted = 0;
+        size_t distinct = 0;
+        tree.inOrderCounted([&counted, &distinct](const int&, size_t copies)
+        {
+            counted += copies;
+            distinct++;
+        });
+        check(counted == sorted.size(), "BPlusTree::inOrderCounted() multiplicities add up");
+        check(distinct == size_t(std::unique(sorted.begin(), sorted.end()) - sorted.begin()),
+              "BPlusTree::inOrderCounted() visits each value once");
+
+        BPlusTree<int> copy(tree);
+        BPlusTree<int> moved(std::move(tree));
+        check(tree.count() == 0 && moved.count() == copy.count(), "BPlusTree move leaves the source empty");
+        while (moved.count() > 0)
+        {
+            int first = 0;
+            moved.inOrder([&first](const int& value) { first = value; return false; });
+            moved.remove(first);
+        }
+        check(moved.count() == 0 && !moved.search(0), "BPlusTree empties by removing every value");
+        check(copy.count() == counted, "BPlusTree copy is independent");
+
+        // The vectorized rank must not compute value - 1 for the smallest int
+        BPlusTree<int> extremes;
+        for (int i = 0; i < 100; i++)
+        {
+            extremes.insert(INT_MIN);
+            extremes.insert(INT_MAX);
+            extremes.insert(i);
+        }
+        check(extremes.search(INT_MIN) && extremes.search(INT_MAX) && !extremes.search(INT_MIN + 1),
+              "BPlusTree handles INT_MIN and INT_MAX");
+        extremes.remove(INT_MIN);
+        check(extremes.count() == 299, "BPlusTree removes INT_MIN");
+
+        BPlusTree<float> floats;
+        for (int i = 0; i < 1000; i++)
+            floats.insert(static_cast<float>(i % 50) / 4);
+        check(floats.count() == 1000 && floats.search(12.25f) && !floats.search(12.3f), "BPlusTree<float>::search()");
+    }
+
+    /**
+     * @brief Checks `PersistentBst` against a sorted vector and checks that snapshots never change
+     *
+     * Each snapshot is compared with the values it was taken from after later inserts, removes
+     * and a clear. A reader thread then traverses snapshots while a writer keeps inserting.
+     */
+    void testPersistentBst()
+    {
+        std::mt19937 random(32);
+        PersistentBst<int> tree;
+        vector<int> sorted;
+        vector<PersistentBst<int>::Snapshot> snapshots;
+        vector<vector<int> > expected;
+        for (int step = 0; step < 5000; step++)
+        {
+            int value = static_cast<int>(random() % 100) - 50;
+            if (random() % 3 == 0)
+            {
+                tree.remove(value);
+                eraseOne(sorted, value);
+            } else
+            {
+                tree.insert(value);
+                sorted.insert(sorted.begin() + rankIn(sorted, value + 1), value);
+            }
+
+            if (step % 250 != 0)
+                continue;
+            int total = 0;
+            for (size_t i = 0; i < sorted.size(); i++)
+                total += sorted[i];
+            check(tree.count() == sorted.size(), "PersistentBst::count()");
+            check(tree.sum() == total, "PersistentBst::sum()");
+            for (int probe = -55; probe <= 55; probe += 5)
+                check(tree.search(probe) == std::binary_search(sorted.begin(), sorted.end(), probe),
+                      "PersistentBst::search()");
+            snapshots.push_back(tree.snapshot());
+            expected.push_back(sorted);
+        }
+
+        PersistentBst<int>::Snapshot last = tree.snapshot();
+        size_t counted = 0;
+        size_t distinct = 0;
+        last.inOrderCounted([&counted, &distinct](const int&, size_t copies)
+        {
+            counted += copies;
+            distinct++;
+        });
+        check(counted == sorted.size(), "PersistentBst multiplicities add up");
+        vector<int> unique(sorted);
+        check(distinct == size_t(std::unique(unique.begin(), unique.end()) - unique.begin()),
+              "PersistentBst keeps one node per distinct value");
+
+        tree.clear();
+        check(tree.count() == 0 && tree.snapshot().isEmpty(), "PersistentBst::clear() publishes an empty version");
+        check(last.count() == counted && valuesOf(last) == sorted, "PersistentBst snapshot survives clear()");
+        for (size_t i = 0; i < snapshots.size(); i++)
+        {
+            long long total = 0;
+            for (size_t j = 0; j < expected[i].size(); j++)
+                total += expected[i][j];
+            check(valuesOf(snapshots[i]) == expected[i], "PersistentBst snapshot keeps its values");
+            check(snapshots[i].count() == expected[i].size() && snapshots[i].sum() == total,
+                  "PersistentBst snapshot keeps its count and sum");
+        }
+
+        // The writer inserts 0, 1, 2, ... so every version holds exactly 0 .. count - 1
+        const int INSERTS = 20000;
+        std::atomic<bool> done(false);
+        bool consistent = true;
+        std::thread reader([&tree, &done, &consistent]()
+        {
+            size_t previous = 0;
+            bool last = false;
+            while (!last)
+            {
+                last = done.load();  // One more pass after the writer stops, so at least one runs
+                PersistentBst<int>::Snapshot snapshot = tree.snapshot();
+                int next = 0;
+                snapshot.inOrder([&next, &consistent](const int& value)
+                {
+                    consistent = consistent && value == next;
+                    next++;
+                });
+                size_t count = snapshot.count();
+                long long total = static_cast<long long>(count) * (static_cast<long long>(count) - 1) / 2;
+                consistent = consistent && size_t(next) == count && snapshot.sum() == total && count >= previous;
+                previous = count;
+            }
+        });
+        for (int value = 0; value < INSERTS; value++)
+            tree.insert(value);
+        done.store(true);
+        reader.join();
+        check(consistent, "PersistentBst snapshots stay consistent while a writer inserts");
+        check(tree.count() == size_t(INSERTS), "PersistentBst counts every concurrent insert");
+    }
+    /**
+     * @brief Checks a `Map` backend against a `std::map` under random inserts and updates
+     *
+     * The keys are drawn from a range wider than the number of inserts early on, so the map
+     * grows through many rehashes while later inserts mostly update existing keys. Every key
+     * of the range is looked up, present or not.
+     *
+     * @param name Name of the backend, for the failure messages.
+     * @param keyOf Makes the key for a number.
+     */
+    template <template <class, class> class Backend, class K, class KeyOf>
+    void testMapBackend(const std::string& name, KeyOf keyOf)
+    {
+        const std::string sizeCheck = name + "::size() counts the distinct keys";
+        const std::string findCheck = name + "::find() returns the last value inserted";
+        const std::string missCheck = name + "::find() misses absent keys";
+        std::mt19937 random(38);
+        Backend<K, int> map;
+        std::map<K, int> expected;
+        check(map.size() == 0 && map.find(keyOf(0)) == nullptr, (name + " starts empty").c_str());
+        for (int step = 1; step <= 6000; step++)
+        {
+            int number = static_cast<int>(random() % 4000) - 2000;
+            map.insert(keyOf(number), step);
+            expected[keyOf(number)] = step;
+
+            if (step % 500 != 0 && step > 40)
+                continue;
+            check(map.size() == expected.size(), sizeCheck.c_str());
+            for (int probe = -2100; probe < 2100; probe++)
+            {
+                K key = keyOf(probe);
+                const int* found = map.find(key);
+                typename std::map<K, int>::const_iterator want = expected.find(key);
+                if (want == expected.end())
+                    check(found == nullptr, missCheck.c_str());
+                else
+                    check(found != nullptr && *found == want->second, findCheck.c_str());
+            }
+        }
+    }
+
+    /// Decimal key of a number, long enough that short-string storage is not the only case
+    std::string stringKey(int number)
+    {
+        return "station-" + std::to_string(number);
+    }
+
+    /**
+     * @brief Checks the flat `Map` backends with int and string keys
+     */
+    void testMapBackends()
+    {
+        testMapBackend<FlatHashMapBackend, int>("FlatHashMapBackend<int>", [](int number) { return number; });
+        testMapBackend<FlatHashMapBackend, std::string>("FlatHashMapBackend<string>", stringKey);
+        testMapBackend<FlatSortedMapBackend, int>("FlatSortedMapBackend<int>", [](int number) { return number; });
+        testMapBackend<FlatSortedMapBackend, std::string>("FlatSortedMapBackend<string>", stringKey);
+
+        // Keys that differ only above the low bits still land apart once the hash is mixed
+        FlatHashMapBackend<int, int> strided;
+        for (int i = 0; i < 3000; i++)
+            strided.insert(i << 12, i);
+        bool allFound = strided.size() == 3000;
+        for (int i = 0; i < 3000; i++)
+        {
+            const int* found = strided.find(i << 12);
+            allFound = allFound && found != nullptr && *found == i && strided.find((i << 12) + 1) == nullptr;
+        }
+        check(allFound, "FlatHashMapBackend finds keys sharing their low bits");
+    }
+}
+
+/**
+ * @brief Checks the tree containers against sorted vectors and the map backends against `std::map`
+ *
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main()
+{
+    testEytzingerTree();
+    testOrderStatBst();
+    testBPlusTree();
+    testPersistentBst();
+    testMapBackends();
+
+    if (g_failures > 0)
+        return 1;
+    cout << "All tree checks passed" << endl;
+    return 0;
+}
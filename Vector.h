@@ -1,8 +1,11 @@
 #ifndef VECTOR_H_INCLUDED
 #define VECTOR_H_INCLUDED
 
+#include <cstddef>
 #include <iostream>
+#include <memory>
 #include <vector>
+#include <utility>
 
 using std::vector;
 
@@ -14,13 +17,19 @@ using std::vector;
  * elements in a dynamic array, allowing users to add, remove, insert, modify, and access elements.
  * It also provides utility functions such as checking the size and whether the vector is empty.
  *
+ * Elements can be moved or constructed in place (`Emplace`), and whole vectors are moved
+ * rather than copied when returned or handed off, so large records are never copied twice.
+ * Sizes and indices are `size_t`, so a vector can hold more than 2^31 elements.
+ *
  * @tparam T The type of elements stored in the vector (e.g., int, double, etc.)
+ * @tparam Alloc The allocator providing the storage, e.g. `AlignedAllocator` for large arrays
+ *               that should be cache-line aligned and backed by huge pages.
  *
  * @author Max Wong
  * @version 1.0
  * @date 11 Nov 2024
  */
-template <class T>
+template <class T, class Alloc = std::allocator<T>>
 class Vector
 {
 public:
@@ -38,7 +47,7 @@ public:
      *
      * @param n The initial capacity of the vector.
      */
-    Vector(int n);
+    Vector(size_t n);
 
     /**
      * @brief Copy constructor
@@ -47,7 +56,7 @@ public:
      *
      * @param other The vector to copy.
      */
-    Vector(const Vector<T>& other);
+    Vector(const Vector<T, Alloc>& other);
 
     /**
      * @brief Assignment operator
@@ -57,7 +66,28 @@ public:
      * @param other The vector to assign from.
      * @return A reference to the current vector object.
      */
-    Vector<T>& operator=(const Vector<T>& other);
+    Vector<T, Alloc>& operator=(const Vector<T, Alloc>& other);
+
+    /**
+     * @brief Move constructor
+     *
+     * Creates a new vector by taking over the elements of another vector, without copying them.
+     * The other vector is left empty.
+     *
+     * @param other The vector to move from.
+     */
+    Vector(Vector<T, Alloc>&& other) noexcept;
+
+    /**
+     * @brief Move assignment operator
+     *
+     * Replaces the contents of this vector with the elements of another vector, without copying
+     * them. The other vector is left empty.
+     *
+     * @param other The vector to move from.
+     * @return A reference to the current vector object.
+     */
+    Vector<T, Alloc>& operator=(Vector<T, Alloc>&& other) noexcept;
 
     /**
      * @brief Destructor
@@ -74,17 +104,50 @@ public:
      * @param n The index of the element to access.
      * @return A constant reference to the element at index `n`.
      */
-    const T& operator[](int n) const;
+    const T& operator[](size_t n) const;
+
+    /**
+     * @brief Access element by index
+     *
+     * Provides read-write access to the element at the specified index.
+     *
+     * @param n The index of the element to access.
+     * @return A reference to the element at index `n`.
+     */
+    T& operator[](size_t n);
 
     /**
-     * @brief Adds an element to the end of the vector
+     * @brief Adds a copy of an element to the end of the vector
      *
      * Adds the specified element to the end of the vector, increasing its size by one.
      *
      * @param element The element to add.
      * @return `true` if the element was successfully added, always `true` in this implementation.
      */
-    bool Add(T element);
+    bool Add(const T& element);
+
+    /**
+     * @brief Moves an element to the end of the vector
+     *
+     * Adds the specified element to the end of the vector by moving it, increasing its size by one.
+     * The element passed in is left in a valid but unspecified state.
+     *
+     * @param element The element to move in.
+     * @return `true` if the element was successfully added, always `true` in this implementation.
+     */
+    bool Add(T&& element);
+
+    /**
+     * @brief Constructs an element in place at the end of the vector
+     *
+     * Builds a new element directly in the vector's storage from the given constructor
+     * arguments, increasing its size by one.
+     *
+     * @param args The arguments forwarded to the element's constructor.
+     * @return A reference to the new element.
+     */
+    template <class... Args>
+    T& Emplace(Args&&... args);
 
     /**
      * @brief Removes the last element from the vector
@@ -104,7 +167,7 @@ public:
      * @param element The element to insert.
      * @return `true` if the element was successfully inserted, `false` if the index is invalid.
      */
-    bool Insert(int index, T element);
+    bool Insert(size_t index, T element);
 
     /**
      * @brief Deletes an element at a specified index
@@ -114,7 +177,7 @@ public:
      * @param index The index of the element to delete.
      * @return `true` if the element was successfully deleted, `false` if the index is invalid.
      */
-    bool Delete(int index);
+    bool Delete(size_t index);
 
     /**
      * @brief Modifies an element at a specified index
@@ -125,7 +188,7 @@ public:
      * @param element The new value for the element at the given index.
      * @return `true` if the element was successfully modified, `false` if the index is invalid.
      */
-    bool Modify(int index, T element);
+    bool Modify(size_t index, T element);
 
     /**
      * @brief Gets the current number of elements in the vector
@@ -134,7 +197,7 @@ public:
      *
      * @return The current number of elements in the vector.
      */
-    int size() const;
+    size_t size() const;
 
     /**
      * @brief Access element at a specified index
@@ -146,7 +209,67 @@ public:
      * @return A constant reference to the element at the given index.
      * @throw std::out_of_range If the index is out of bounds.
      */
-    const T& at(int n) const;
+    const T& at(size_t n) const;
+
+    /**
+     * @brief Access element at a specified index
+     *
+     * Provides bounds-checked read-write access to an element at the specified index.
+     *
+     * @param n The index of the element to access.
+     * @return A reference to the element at the given index.
+     * @throw std::out_of_range If the index is out of bounds.
+     */
+    T& at(size_t n);
+
+    /**
+     * @brief Reserves storage for a number of elements
+     *
+     * Makes sure the vector can hold at least `n` elements without reallocating.
+     *
+     * @param n The number of elements to reserve space for.
+     */
+    void Reserve(size_t n);
+
+    /**
+     * @brief Releases unused storage
+     *
+     * Reduces the capacity of the vector to its size.
+     */
+    void Shrink();
+
+    /**
+     * @brief Gets the number of elements the vector can hold without reallocating
+     *
+     * @return The current capacity of the vector.
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Removes every element from the vector
+     *
+     * The capacity is kept, so the vector can be refilled without reallocating.
+     */
+    void Clear();
+
+    typedef typename vector<T, Alloc>::iterator iterator;              ///< Read-write iterator
+    typedef typename vector<T, Alloc>::const_iterator const_iterator;  ///< Read-only iterator
+
+    /**
+     * @brief Gets an iterator to the first element
+     *
+     * @return An iterator to the first element, or `end()` if the vector is empty.
+     */
+    iterator begin();
+    const_iterator begin() const;
+
+    /**
+     * @brief Gets an iterator past the last element
+     *
+     * @return An iterator past the last element.
+     */
+    iterator end();
+    const_iterator end() const;
 
     /**
      * @brief Checks if the vector is empty
@@ -158,47 +281,79 @@ public:
     bool isEmpty() const;
 
 private:
-    vector<T> m_array; ///< The underlying STL vector used to store the elements
+    vector<T, Alloc> m_array; ///< The underlying STL vector used to store the elements
 };
 
-template <class T>
-Vector<T>::Vector() {}
+template <class T, class Alloc>
+Vector<T, Alloc>::Vector() {}
 
-template <class T>
-Vector<T>::Vector(int n)
+template <class T, class Alloc>
+Vector<T, Alloc>::Vector(size_t n)
 {
     m_array.reserve(n);  // Reserve space for n elements
 }
 
-template <class T>
-Vector<T>::~Vector() {}
+template <class T, class Alloc>
+Vector<T, Alloc>::~Vector() {}
 
-template <class T>
-Vector<T>::Vector(const Vector<T>& other) : m_array(other.m_array) {}
+template <class T, class Alloc>
+Vector<T, Alloc>::Vector(const Vector<T, Alloc>& other) : m_array(other.m_array) {}
 
-template <class T>
-Vector<T>& Vector<T>::operator=(const Vector<T>& other)
+template <class T, class Alloc>
+Vector<T, Alloc>& Vector<T, Alloc>::operator=(const Vector<T, Alloc>& other)
 {
     if (this != &other)
         m_array = other.m_array;
     return *this;
 }
 
-template <class T>
-const T& Vector<T>::operator[](int n) const
+template <class T, class Alloc>
+Vector<T, Alloc>::Vector(Vector<T, Alloc>&& other) noexcept : m_array(std::move(other.m_array)) {}
+
+template <class T, class Alloc>
+Vector<T, Alloc>& Vector<T, Alloc>::operator=(Vector<T, Alloc>&& other) noexcept
+{
+    if (this != &other)
+        m_array = std::move(other.m_array);  // Take over the storage, no element is copied
+    return *this;
+}
+
+template <class T, class Alloc>
+const T& Vector<T, Alloc>::operator[](size_t n) const
 {
     return m_array[n];  // Access element at index n
 }
 
-template <class T>
-bool Vector<T>::Add(T element)
+template <class T, class Alloc>
+T& Vector<T, Alloc>::operator[](size_t n)
+{
+    return m_array[n];  // Access element at index n
+}
+
+template <class T, class Alloc>
+bool Vector<T, Alloc>::Add(const T& element)
 {
     m_array.push_back(element);  // Use STL vector's push_back method
     return true;
 }
 
-template <class T>
-bool Vector<T>::Remove()
+template <class T, class Alloc>
+bool Vector<T, Alloc>::Add(T&& element)
+{
+    m_array.push_back(std::move(element));  // Move the element in, no copy
+    return true;
+}
+
+template <class T, class Alloc>
+template <class... Args>
+T& Vector<T, Alloc>::Emplace(Args&&... args)
+{
+    m_array.emplace_back(std::forward<Args>(args)...);  // Construct directly in the storage
+    return m_array.back();
+}
+
+template <class T, class Alloc>
+bool Vector<T, Alloc>::Remove()
 {
     if (!m_array.empty())
     {
@@ -208,21 +363,21 @@ bool Vector<T>::Remove()
     return false;  // No element to remove
 }
 
-template <class T>
-bool Vector<T>::Insert(int index, T element)
+template <class T, class Alloc>
+bool Vector<T, Alloc>::Insert(size_t index, T element)
 {
-    if (index >= 0 && index <= m_array.size())
+    if (index <= m_array.size())
     {
-        m_array.insert(m_array.begin() + index, element);  // Insert element at index
+        m_array.insert(m_array.begin() + index, std::move(element));  // Insert element at index
         return true;
     }
     return false;  // Invalid index
 }
 
-template <class T>
-bool Vector<T>::Delete(int index)
+template <class T, class Alloc>
+bool Vector<T, Alloc>::Delete(size_t index)
 {
-    if (index >= 0 && index < m_array.size())
+    if (index < m_array.size())
     {
         m_array.erase(m_array.begin() + index);  // Delete element at index
         return true;
@@ -230,31 +385,85 @@ bool Vector<T>::Delete(int index)
     return false;  // Invalid index
 }
 
-template <class T>
-bool Vector<T>::Modify(int index, T element)
+template <class T, class Alloc>
+bool Vector<T, Alloc>::Modify(size_t index, T element)
 {
-    if (index >= 0 && index < m_array.size())
+    if (index < m_array.size())
     {
-        m_array[index] = element;  // Modify element at index
+        m_array[index] = std::move(element);  // Modify element at index
         return true;
     }
     return false;  // Invalid index
 }
 
-template <class T>
-int Vector<T>::size() const
+template <class T, class Alloc>
+size_t Vector<T, Alloc>::size() const
 {
     return m_array.size();  // Use STL vector's size method
 }
 
-template <class T>
-const T& Vector<T>::at(int n) const
+template <class T, class Alloc>
+const T& Vector<T, Alloc>::at(size_t n) const
+{
+    return m_array.at(n);  // Use STL vector's at() method for bounds checking
+}
+
+template <class T, class Alloc>
+T& Vector<T, Alloc>::at(size_t n)
 {
     return m_array.at(n);  // Use STL vector's at() method for bounds checking
 }
 
-template <class T>
-bool Vector<T>::isEmpty() const
+template <class T, class Alloc>
+void Vector<T, Alloc>::Reserve(size_t n)
+{
+    m_array.reserve(n);
+}
+
+template <class T, class Alloc>
+void Vector<T, Alloc>::Shrink()
+{
+    m_array.shrink_to_fit();
+}
+
+template <class T, class Alloc>
+size_t Vector<T, Alloc>::capacity() const
+{
+    return m_array.capacity();
+}
+
+template <class T, class Alloc>
+void Vector<T, Alloc>::Clear()
+{
+    m_array.clear();
+}
+
+template <class T, class Alloc>
+typename Vector<T, Alloc>::iterator Vector<T, Alloc>::begin()
+{
+    return m_array.begin();
+}
+
+template <class T, class Alloc>
+typename Vector<T, Alloc>::const_iterator Vector<T, Alloc>::begin() const
+{
+    return m_array.begin();
+}
+
+template <class T, class Alloc>
+typename Vector<T, Alloc>::iterator Vector<T, Alloc>::end()
+{
+    return m_array.end();
+}
+
+template <class T, class Alloc>
+typename Vector<T, Alloc>::const_iterator Vector<T, Alloc>::end() const
+{
+    return m_array.end();
+}
+
+template <class T, class Alloc>
+bool Vector<T, Alloc>::isEmpty() const
 {
     return m_array.empty();  // Use STL vector's empty() method
 }
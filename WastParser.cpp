@@ -0,0 +1,93 @@
+#include "WastParser.h"
+#include <cstdint>
+#include <cstring>
+
+static const size_t FIXED_LENGTH = 16;  // dd/mm/yyyy hh:mm
+
+// Expected bytes of "00/00/0000 00:00", little-endian, split into two words
+static const uint64_t TEMPLATE_LOW = 0x30302F30302F3030ull;   // "00/00/00"
+static const uint64_t TEMPLATE_HIGH = 0x30303A3030203030ull;  // "00 00:00"
+// Separator bytes, which must match the template exactly
+static const uint64_t SEPARATORS_LOW = 0x0000FF0000FF0000ull;
+static const uint64_t SEPARATORS_HIGH = 0x0000FF0000FF0000ull;
+static const uint64_t HIGH_BITS = 0x8080808080808080ull;
+static const uint64_t ABOVE_NINE = 0x7676767676767676ull;  // Added to a byte, sets its high bit if it is 10 or more
+
+// Byte n of a word
+static inline int byteAt(uint64_t word, int n)
+{
+    return static_cast<int>((word >> (8 * n)) & 0xFF);
+}
+
+bool WastParser::parse(const char* text, size_t length, Date& date, Time& time)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (length == FIXED_LENGTH)
+        return parseFixed(text, date, time);
+#endif
+    return parseVariable(text, length, date, time);
+}
+
+bool WastParser::parseFixed(const char* text, Date& date, Time& time)
+{
+    uint64_t low;
+    uint64_t high;
+    std::memcpy(&low, text, sizeof(low));
+    std::memcpy(&high, text + sizeof(low), sizeof(high));
+
+    // Digits become their values 0-9 and matching separators become 0
+    low ^= TEMPLATE_LOW;
+    high ^= TEMPLATE_HIGH;
+    // A byte of 10 or more, or with its high bit set, is not a digit; a non-zero separator is wrong
+    if (((low | (low + ABOVE_NINE)) & HIGH_BITS) != 0 || ((high | (high + ABOVE_NINE)) & HIGH_BITS) != 0 ||
+        (low & SEPARATORS_LOW) != 0 || (high & SEPARATORS_HIGH) != 0)
+        return parseVariable(text, FIXED_LENGTH, date, time);  // Not the fixed layout, try the slow path
+
+    // Byte n becomes 10 * digit n + digit n + 1, the value of the two-digit number starting at n
+    uint64_t pairsLow = low * 10 + (low >> 8) + (high << 56);
+    uint64_t pairsHigh = high * 10 + (high >> 8);
+
+    return store(byteAt(pairsLow, 0),                                  // dd
+                 byteAt(pairsLow, 3),                                  // mm
+                 byteAt(pairsLow, 6) * 100 + byteAt(pairsHigh, 0),     // yyyy
+                 byteAt(pairsHigh, 3),                                 // hh
+                 byteAt(pairsHigh, 6),                                 // mm
+                 date, time);
+}
+
+bool WastParser::parseVariable(const char* text, size_t length, Date& date, Time& time)
+{
+    const char* end = text + length;
+    // Reads between `minDigits` and `maxDigits` digits followed by `separator` (0 at the end)
+    auto number = [&text, end](int minDigits, int maxDigits, char separator, int& value)
+    {
+        value = 0;
+        int digits = 0;
+        while (text < end && *text >= '0' && *text <= '9' && digits < maxDigits)
+        {
+            value = value * 10 + (*text++ - '0');
+            digits++;
+        }
+        if (digits < minDigits)
+            return false;
+        if (separator == 0)
+            return text == end;
+        return text < end && *text++ == separator;
+    };
+
+    int day, month, year, hour, minute;
+    if (!number(1, 2, '/', day) || !number(1, 2, '/', month) || !number(4, 4, ' ', year) ||
+        !number(1, 2, ':', hour) || !number(2, 2, 0, minute))
+        return false;
+    return store(day, month, year, hour, minute, date, time);
+}
+
+bool WastParser::store(int day, int month, int year, int hour, int minute, Date& date, Time& time)
+{
+    if (month < 1 || month > 12 || day < 1 || day > Calendar::daysInMonth(month, year) ||
+        hour > 23 || minute > 59)
+        return false;
+    date = Date(day, month, year);
+    time = Time(hour, minute);
+    return true;
+}
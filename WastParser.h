@@ -0,0 +1,41 @@
+#ifndef WASTPARSER_H_INCLUDED
+#define WASTPARSER_H_INCLUDED
+
+#include <cstddef>
+#include "Date.h"
+#include "Time.h"
+
+/**
+ * @class WastParser
+ * @brief Parser for the `WAST` timestamp column of the weather files
+ *
+ * A timestamp is normally written as `dd/mm/yyyy hh:mm`, exactly 16 bytes. That layout is
+ * parsed without a loop or a branch per character: the field is loaded as two 64-bit words,
+ * every digit and separator is checked at once with SWAR (SIMD within a register) masks, and
+ * neighbouring digits are combined pairwise with one multiply-add per word. Shorter variants
+ * with a single-digit day, month or hour (e.g. `1/3/2016 9:00`) take a slower character loop.
+ *
+ * Every field is validated: a timestamp with a wrong layout, a non-digit, a month outside
+ * 1-12, a day past the end of its month, an hour past 23 or a minute past 59 is rejected.
+ */
+class WastParser
+{
+public:
+    /**
+     * @brief Parses a WAST timestamp
+     *
+     * @param text The characters of the timestamp, not necessarily null-terminated.
+     * @param length The number of characters.
+     * @param date Receives the date when the timestamp is valid.
+     * @param time Receives the time when the timestamp is valid.
+     * @return `true` if the timestamp is valid, `false` if it was rejected.
+     */
+    static bool parse(const char* text, size_t length, Date& date, Time& time);
+
+private:
+    static bool parseFixed(const char* text, Date& date, Time& time);
+    static bool parseVariable(const char* text, size_t length, Date& date, Time& time);
+    static bool store(int day, int month, int year, int hour, int minute, Date& date, Time& time);
+};
+
+#endif // WASTPARSER_H_INCLUDED
@@ -1,7 +1,13 @@
 #include "weather.h"
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
 
 
 Weather::Weather()
+    : m_dataVersion(0), m_windCache(QUERY_CACHE_SIZE), m_temperatureCache(QUERY_CACHE_SIZE),
+      m_solarCache(QUERY_CACHE_SIZE), m_correlationCache(QUERY_CACHE_SIZE)
 {
     Vector<WeatherData> m_data;
     Date date;
@@ -13,86 +19,143 @@ Weather::Weather()
 
 bool Weather::loadDataFromFile(const string& filename)
 {
-    ifstream file(filename);
-    if (!file) {
-        cout << "Error: Could not open file " << filename << endl;
-        return false;
+    bool loaded = parseDataFile(filename, m_data, cout);
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_dataVersion++; // Results computed before this load no longer match the data
     }
+    return loaded;
+}
 
-    string header;
-    getline(file, header); // Read the header line
+vector<char> Weather::loadDataFromFiles(const vector<string>& filenames, vector<string>& messages)
+{
+    // One task per file; a worker left idle by a small file steals the next one waiting
+    size_t count = filenames.size();
+    vector<DataStore> records(count);
+    vector<std::ostringstream> logs(count);
+    vector<char> loaded(count, 0);
+    TaskScheduler::shared().parallelFor(0, count, 1, [&](size_t first, size_t last)
+    {
+        for (size_t f = first; f < last; f++)
+            loaded[f] = parseDataFile(filenames[f], records[f], logs[f]);
+    });
+
+    // Add the records in the order of the files, as if they had been loaded one by one. Each
+    // task copies one slice of the new records, so the pages of every slice are first written
+    // by the thread filling it, sliced like the scans
+    vector<size_t> offsets(count + 1, m_data.size());
+    for (size_t f = 0; f < count; f++)
+        offsets[f + 1] = offsets[f] + records[f].size();
+    m_data.Extend(offsets[count] - offsets[0]);
+    TaskScheduler::shared().parallelFor(offsets[0], offsets[count], SCAN_GRAIN, [&](size_t first, size_t last)
+    {
+        size_t f = std::upper_bound(offsets.begin(), offsets.end(), first) - offsets.begin() - 1;
+        for (size_t i = first; i < last; i++)
+        {
+            while (i >= offsets[f + 1])
+                f++;  // Skips the files with no record too
+            m_data.ConstructAt(i, records[f][i - offsets[f]]);
+        }
+    });
 
-    // Initialize column indices
-    int wastIndex = -1, windIndex = -1, tempIndex = -1, solarIndex = -1;
-    int columnIndex = 0;
-    string column; // Hold current column name
+    messages.resize(count);
+    for (size_t f = 0; f < count; f++)
+    {
+        records[f].Clear();
+        messages[f] = logs[f].str();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_dataVersion++; // Results computed before this load no longer match the data
+    }
+    return loaded;
+}
+
+bool Weather::parseDataFile(const string& filename, DataStore& records, std::ostream& log)
+{
+    bool ok = false;
+    for (const WeatherData& data : readRecords(filename, log, ok))
+        records.Add(data);
+    return ok;
+}
+
+Generator<WeatherData> Weather::readRecords(string filename, std::ostream& log, bool& ok)
+{
+    ok = false;
+    ChunkReader file(filename); // Reads ahead on its own thread while the lines below are parsed
+    if (!file.isOpen()) {
+        log << "Error: Could not open file " << filename << endl;
+        co_return;
+    }
 
-    // Parse header to determine column indices
-    for (size_t i = 0; i <= header.length(); ++i)
+    // Initialize column indices
+    size_t wastIndex = string::npos, windIndex = string::npos, tempIndex = string::npos, solarIndex = string::npos;
+    const char* line;
+    size_t length;
+    if (file.nextLine(line, length)) // The first line is the header
     {
-        if (i == header.length() || header[i] == ',') // End of line or comma
+        size_t columnIndex = 0;
+        string column; // Hold current column name
+
+        // Parse header to determine column indices
+        for (size_t i = 0; i <= length; ++i)
         {
-            if (column == "WAST") wastIndex = columnIndex;
-            else if (column == "S") windIndex = columnIndex;
-            else if (column == "T") tempIndex = columnIndex;
-            else if (column == "SR") solarIndex = columnIndex;
-
-            // Move to the next column
-            column.clear(); // Reset for the next column
-            columnIndex++;
-        } else
-            column += header[i]; // Build column name character by character
+            if (i == length || line[i] == ',') // End of line or comma
+            {
+                if (column == "WAST") wastIndex = columnIndex;
+                else if (column == "S") windIndex = columnIndex;
+                else if (column == "T") tempIndex = columnIndex;
+                else if (column == "SR") solarIndex = columnIndex;
+
+                // Move to the next column
+                column.clear(); // Reset for the next column
+                columnIndex++;
+            } else
+                column += line[i]; // Build column name character by character
+        }
     }
 
     // Check if all expected columns were found
-    if (wastIndex == -1 || windIndex == -1 || tempIndex == -1 || solarIndex == -1)
+    if (wastIndex == string::npos || windIndex == string::npos || tempIndex == string::npos || solarIndex == string::npos)
     {
-        cout << "Error: Missing expected columns in the header." << endl;
-        return false;
+        if (file.failed())
+            log << "Error: Could not read file " << filename << endl;
+        else
+            log << "Error: Missing expected columns in the header." << endl;
+        co_return;
     }
+    ok = true;
 
     // Read data lines
-    string line;
-    while (getline(file, line))
+    Vector<string> cells; // Vector to hold the split cell values, reused for every line
+    size_t rejected = 0; // Rows skipped because of a malformed timestamp
+    while (file.nextLine(line, length))
     {
-        Vector<string> cells; // Vector to hold the split cell values
-        string cell; // To hold the current cell value
-        columnIndex = 0; // Reset column index for data line
+        cells.Clear();
 
         // Parse the line into cells
-        for (size_t i = 0; i <= line.length(); ++i)
+        size_t start = 0;
+        for (size_t i = 0; i <= length; ++i)
         {
-            if (i == line.length() || line[i] == ',')
+            if (i == length || line[i] == ',')
             {
-                cells.Add(cell); // Add the cell value to the vector
-                cell.clear(); // Reset for the next cell
-                columnIndex++;
-            } else
-                cell += line[i]; // Build the cell value character by character
+                cells.Emplace(line + start, i - start);
+                start = i + 1; // The next cell starts after the comma
+            }
         }
 
         // Ensure enough data was read
         if (cells.size() > wastIndex && cells.size() > windIndex &&
             cells.size() > tempIndex && cells.size() > solarIndex)
         {
-            WeatherData data;
-
-            // Parse date and time
-            string wastStr = cells[wastIndex];
-            size_t spacePos = wastStr.find(' ');
-            string dateStr = wastStr.substr(0, spacePos);
-            string timeStr = wastStr.substr(spacePos + 1);
-
-            // Parse date
-            int day = (dateStr[0] - '0') * 10 + (dateStr[1] - '0');
-            int month = (dateStr[3] - '0') * 10 + (dateStr[4] - '0');
-            int year = (dateStr[6] - '0') * 1000 + (dateStr[7] - '0') * 100 + (dateStr[8] - '0') * 10 + (dateStr[9] - '0');
-            data.date = Date(day, month, year);
-
-            // Parse time
-            int hour = (timeStr[0] - '0') * 10 + (timeStr[1] - '0');
-            int minute = (timeStr[3] - '0') * 10 + (timeStr[4] - '0');
-            data.time = Time(hour, minute);
+            // Parse date and time, rejecting the row if the timestamp is malformed
+            const string& wastStr = cells[wastIndex];
+            WeatherData data = WeatherData(); // Measurements left out of the row stay 0
+            if (!WastParser::parse(wastStr.data(), wastStr.size(), data.date, data.time))
+            {
+                rejected++;
+                continue;
+            }
 
             // Parse measurements
             if (!cells[windIndex].empty() && cells[windIndex] != "N/A")
@@ -109,73 +172,125 @@ bool Weather::loadDataFromFile(const string& filename)
                 if (solar >= 100)   // Only include values more than 100 W/m2
                     data.solarRadiation = solar;
             }
-            m_data.Add(data);
+            co_yield data; // Suspended here until the consumer asks for the next record
         }
     }
+
+    if (rejected > 0)
+        log << "Warning: Skipped " << rejected << " rows with a malformed timestamp in " << filename << endl;
+    if (file.failed())
+    {
+        log << "Error: Could not read file " << filename << endl;
+        ok = false;
+    }
+}
+
+bool Weather::fileWindStats(const string& filename, int month, int year, MonthStats& stats, std::ostream& log)
+{
+    // Records are in chronological order: skip those before the month and stop reading at the first after it
+    auto beforeMonth = [month, year](const WeatherData& data)
+    {
+        return data.date.GetYear() < year || (data.date.GetYear() == year && data.date.GetMonth() < month);
+    };
+    auto inMonth = [month, year](const WeatherData& data)
+    {
+        return data.date.GetYear() == year && data.date.GetMonth() == month;
+    };
+    auto windSpeed = [](const WeatherData& data)
+    {
+        return static_cast<float>(data.windSpeed * 3.6); // Convert to km/h
+    };
+
+    bool ok = false;
+    vector<float> windSpeeds;
+    for (float speed : readRecords(filename, log, ok).dropWhile(beforeMonth).takeWhile(inMonth).map(windSpeed))
+        windSpeeds.push_back(speed);
+    if (!ok)
+        return false;
+    stats = summarize(windSpeeds);
     return true;
 }
 
-Vector<float> Weather::bstToVector(Bst<float>& bst) const
+void Weather::calculateWindStats(int month, int year)
 {
-    Vector<float> result;
-    inOrderToVector(bst.getRoot(), result);
-    return result;
+    ReportWriter out(stdout);
+    formatWindStats(out, month, year, windStats(month, year));
 }
 
-// Recursive helper function for in-order traversal
-void Weather::inOrderToVector(Node<float>* node, Vector<float>& vec) const
+MonthStats Weather::windStats(int month, int year)
 {
-    if (node != nullptr)
+    uint64_t key = static_cast<uint64_t>(static_cast<uint32_t>(year)) << 4 | static_cast<uint64_t>(month & 0xF);
+    uint64_t version;  // Version the result is computed from, a load meanwhile makes it outdated
     {
-        inOrderToVector(node->left, vec);
-        vec.Add(node->data);
-        inOrderToVector(node->right, vec);
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        version = m_dataVersion;
+        if (const MonthStats* cached = m_windCache.find(key, version))
+            return *cached;
     }
-}
-
 
-void Weather::calculateWindStats(int month, int year)
-{
-    Vector<WeatherData> monthData = getDataForMonth(month, year);
-    if (monthData.isEmpty())
+    vector<float> windSpeeds;
+    for (size_t i = 0; i < m_data.size(); i++)
     {
-        cout << Date().SetMonthName(month) << " " << year << ": No Data" << endl;
-        return;
+        const WeatherData& data = m_data[i];
+        if (data.date.GetMonth() == month && data.date.GetYear() == year)
+            windSpeeds.push_back(data.windSpeed * 3.6); // Convert to km/h
     }
+    MonthStats stats = summarize(windSpeeds);  // Computed unlocked, other queries proceed meanwhile
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    return m_windCache.insert(key, version, stats);
+}
 
-    Bst<float> monthWindBST;
-    for (int i = 0; i < monthData.size(); i++)
+void Weather::formatWindStats(ReportWriter& out, int month, int year, const MonthStats& stats)
+{
+    if (stats.count == 0)
     {
-        monthWindBST.insert(monthData[i].windSpeed * 3.6); // Convert to km/h
+        out << Date().SetMonthName(month) << ' ' << year << ": No Data\n";
+        return;
     }
-    double mean = calculateMean(monthWindBST);
-    double stdev = calculateStdev(monthWindBST, mean);
+    out << Date().SetMonthName(month) << ' ' << year << ":\n";
+    out << "Average speed: " << stats.mean << " km/h\n";
+    out << "Sample stdev: " << stats.stdev << '\n';
+}
 
-    cout << Date().SetMonthName(month) << " " << year << ":" << endl;
-    cout << "Average speed: " << mean << " km/h" << endl;
-    cout << "Sample stdev: " << stdev << endl;
+MonthStats Weather::summarize(const vector<float>& values)
+{
+    MonthStats stats;
+    stats.count = values.size();
+    if (stats.count == 0)
+        return stats;
+    Bst<float> bst(values.begin(), values.end()); // One sort plus a linear build
+    stats.mean = calculateMean(bst);
+    stats.stdev = calculateStdev(bst, stats.mean);
+    stats.mad = calculateMAD(bst, stats.mean);
+    return stats;
 }
 
 double Weather::calculateMean(Bst<float>& bst)
 {
-    int count = bst.count();
+    size_t count = bst.count();
     if (count == 0) return 0; // No data in BST
-    double sum = bst.sum();
+    double sum = 0;
+    // Accumulate in double, Bst<float>::sum() would round every partial sum to float
+    bst.inOrderCounted([&sum](float value, size_t copies)
+    {
+        sum += static_cast<double>(value) * copies;
+    });
     return sum / count;
 }
 
 double Weather::calculateStdev(Bst<float>& bst, double mean)
 {
-    Vector<float> values = bstToVector(bst); // Convert bst to vector for easier variance calculation to each values
-    if (values.size() < 2)
+    size_t count = bst.count();
+    if (count < 2)
         return 0;
     double sumSquares = 0;
-    for (int i = 0; i < values.size(); i++)
+    // Walk each distinct value once, weighted by how many times it was recorded
+    bst.inOrderCounted([&sumSquares, mean](float value, size_t copies)
     {
-        double diff = values[i] - mean;
-        sumSquares += diff * diff;
-    }
-    return sqrt(sumSquares / (values.size() - 1));
+        double diff = value - mean;
+        sumSquares += diff * diff * copies;
+    });
+    return sqrt(sumSquares / (count - 1));
 }
 
 double Weather::calculateSPCC(const Vector<float>& x, const Vector<float>& y)
@@ -186,7 +301,7 @@ double Weather::calculateSPCC(const Vector<float>& x, const Vector<float>& y)
     double sum_x2 = 0.0;
     double sum_y2 = 0.0;
 
-    for (int i = 0; i < x.size(); i++)
+    for (size_t i = 0; i < x.size(); i++)
     {
         sum_x += x[i];        // Sum of x
         sum_y += y[i];        // Sum of y
@@ -206,13 +321,28 @@ double Weather::calculateSPCC(const Vector<float>& x, const Vector<float>& y)
 
 void Weather::calculateSPCCForMonth(int month)
 {
+    ReportWriter out(stdout);
+    formatCorrelation(out, month, correlation(month));
+}
+
+CorrelationResult Weather::correlation(int month)
+{
+    uint64_t key = static_cast<uint64_t>(month & 0xF);
+    uint64_t version;  // Version the result is computed from, a load meanwhile makes it outdated
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        version = m_dataVersion;
+        if (const CorrelationResult* cached = m_correlationCache.find(key, version))
+            return *cached;
+    }
+
     Vector<float> wind_speed;
     Vector<float> temp;
     Vector<float> solar_radiation;
 
-    for (int i = 0; i < m_data.size(); i++)
+    for (size_t i = 0; i < m_data.size(); i++)
     {
-        WeatherData data = m_data[i];
+        const WeatherData& data = m_data[i];
         if (data.date.GetMonth() == month)
         {
             wind_speed.Add(data.windSpeed);
@@ -221,22 +351,27 @@ void Weather::calculateSPCCForMonth(int month)
         }
     }
 
-    double s_t = calculateSPCC(wind_speed, temp);
-    double s_r = calculateSPCC(wind_speed, solar_radiation);
-    double t_r = calculateSPCC(temp, solar_radiation);
-
-    // Output the results
-    cout << "Sample Pearson Correlation Coefficient for " << Date().SetMonthName(month) << endl;
-    cout << "S_T: " << s_t << endl;
-    cout << "S_R: " << s_r << endl;
-    cout << "T_R: " << t_r << endl;
+    CorrelationResult result;
+    result.count = wind_speed.size();
+    result.windTemperature = calculateSPCC(wind_speed, temp);
+    result.windSolar = calculateSPCC(wind_speed, solar_radiation);
+    result.temperatureSolar = calculateSPCC(temp, solar_radiation);
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    return m_correlationCache.insert(key, version, result);
+}
 
+void Weather::formatCorrelation(ReportWriter& out, int month, const CorrelationResult& result)
+{
+    out << "Sample Pearson Correlation Coefficient for " << Date().SetMonthName(month) << '\n';
+    out << "S_T: " << result.windTemperature << '\n';
+    out << "S_R: " << result.windSolar << '\n';
+    out << "T_R: " << result.temperatureSolar << '\n';
 }
 
 Vector<WeatherData> Weather::getDataForMonth(int month, int year)
 {
     Vector<WeatherData> monthData;
-    for (int i = 0; i < m_data.size(); i++)
+    for (size_t i = 0; i < m_data.size(); i++)
     {
         if (m_data[i].date.GetMonth() == month && m_data[i].date.GetYear() == year)
             monthData.Add(m_data[i]);
@@ -247,7 +382,7 @@ Vector<WeatherData> Weather::getDataForMonth(int month, int year)
 Vector<WeatherData> Weather::getDataForYear(int year)
 {
     Vector<WeatherData> yearData;
-    for (int i = 0; i < m_data.size(); i++)
+    for (size_t i = 0; i < m_data.size(); i++)
     {
         if (m_data[i].date.GetYear() == year)
             yearData.Add(m_data[i]);
@@ -257,169 +392,408 @@ Vector<WeatherData> Weather::getDataForYear(int year)
 
 void Weather::calculateTempStats(int year)
 {
-    Vector<WeatherData> yearData = getDataForYear(year);
-    if (yearData.isEmpty())
+    ReportWriter out(stdout);
+    formatTempStats(out, year, temperatureStats(year));
+}
+
+std::array<MonthStats, 12> Weather::temperatureStats(int year)
+{
+    uint64_t key = static_cast<uint32_t>(year);
+    uint64_t version;  // Version the result is computed from, a load meanwhile makes it outdated
     {
-        cout << year << ": No Data" << endl;
-        return;
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        version = m_dataVersion;
+        if (const std::array<MonthStats, 12>* cached = m_temperatureCache.find(key, version))
+            return *cached;
     }
 
-    cout << year << endl;
-    // Process each month
-    for (int month = 1; month <= 12; month++)
+    // Collect the temperatures of every month in one pass over the data, one slice per task;
+    // the order of the values does not matter, summarize sorts them
+    vector<float> temperatures[12];
+    std::mutex mergeMutex;
+    TaskScheduler& scheduler = TaskScheduler::shared();
+    scheduler.parallelFor(0, m_data.size(), SCAN_GRAIN, [&](size_t first, size_t last)
     {
-        Bst<float> yearTempBST;
-        Vector<WeatherData> monthData = getDataForMonth(month, year);
-
-        // Collect valid temperature readings for the month
-        for (int i = 0; i < monthData.size(); i++)
+        vector<float> slice[12];
+        for (size_t i = first; i < last; i++)
         {
-            yearTempBST.insert(monthData[i].temperature);
+            const WeatherData& data = m_data[i];
+            if (data.date.GetYear() == year)
+                slice[data.date.GetMonth() - 1].push_back(data.temperature);
         }
+        std::lock_guard<std::mutex> lock(mergeMutex);
+        for (int month = 0; month < 12; month++)
+            temperatures[month].insert(temperatures[month].end(), slice[month].begin(), slice[month].end());
+    });
 
-        if (yearTempBST.count() > 0)
-        {
-            double mean = calculateMean(yearTempBST);
-            double stdev = calculateStdev(yearTempBST, mean);
-            cout << Date().SetMonthName(month) << ": average: " << mean << " degrees C, stdev: " << stdev << endl;
-        } else
-            cout << Date().SetMonthName(month) << ": No Data" << endl;
-    }
+    std::array<MonthStats, 12> months;
+    scheduler.parallelFor(0, 12, 1, [&](size_t first, size_t last)
+    {
+        for (size_t month = first; month < last; month++)
+            months[month] = summarize(temperatures[month]);
+    });
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    return m_temperatureCache.insert(key, version, months);
 }
 
-void Weather::calculateSolarRadiation(int year)
+void Weather::formatTempStats(ReportWriter& out, int year, const std::array<MonthStats, 12>& months)
 {
-    Vector<WeatherData> yearData = getDataForYear(year);
-    if (yearData.isEmpty())
+    bool hasData = false;
+    for (int month = 0; month < 12; month++)
+        hasData |= months[month].count > 0;
+    if (!hasData)
     {
-        cout << year << ": No Data" << endl;
+        out << year << ": No Data\n";
         return;
     }
 
-    cout << year << endl;
-
-    // Process each month
+    out << year << '\n';
     for (int month = 1; month <= 12; month++)
     {
-        Vector<WeatherData> monthData = getDataForMonth(month, year);
-        float totalRadiation = 0.0f;
-        bool hasData = false;
+        const MonthStats& stats = months[month - 1];
+        if (stats.count > 0)
+            out << Date().SetMonthName(month) << ": average: " << stats.mean << " degrees C, stdev: " << stats.stdev << '\n';
+        else
+            out << Date().SetMonthName(month) << ": No Data\n";
+    }
+}
+
+void Weather::calculateSolarRadiation(int year)
+{
+    ReportWriter out(stdout);
+    formatSolarRadiation(out, year, solarRadiationStats(year));
+}
+
+std::array<SolarStats, 12> Weather::solarRadiationStats(int year)
+{
+    uint64_t key = static_cast<uint32_t>(year);
+    uint64_t version;  // Version the result is computed from, a load meanwhile makes it outdated
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        version = m_dataVersion;
+        if (const std::array<SolarStats, 12>* cached = m_solarCache.find(key, version))
+            return *cached;
+    }
 
-        // Sum up radiation values for the month
-        for (int i = 0; i < monthData.size(); i++)
+    std::array<SolarStats, 12> months;
+    float totals[12] = {}; // Summed in float, as the totals have always been
+    for (size_t i = 0; i < m_data.size(); i++)
+    {
+        const WeatherData& data = m_data[i];
+        if (data.date.GetYear() != year)
+            continue;
+        int month = data.date.GetMonth() - 1;
+        months[month].count++;
+        if (data.solarRadiation >= 100)  // Only include values of at least 100 W/m2
         {
-            if (monthData[i].solarRadiation >= 100)  // Only include values ≥ 100 W/m2
-            {
-                // Convert W/m2 to kWh/m2
-                totalRadiation += (monthData[i].solarRadiation / 1000.0f); // f to treat as float
-                hasData = true;
-            }
+            totals[month] += (data.solarRadiation / 1000.0f); // Convert W/m2 to kWh/m2
+            months[month].measured++;
         }
+    }
+    for (int month = 0; month < 12; month++)
+        months[month].total = totals[month];
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    return m_solarCache.insert(key, version, months);
+}
 
-        if (hasData)
-            cout << Date().SetMonthName(month) << ": " << totalRadiation << " kWh/m2" << endl;
+void Weather::formatSolarRadiation(ReportWriter& out, int year, const std::array<SolarStats, 12>& months)
+{
+    bool hasData = false;
+    for (int month = 0; month < 12; month++)
+        hasData |= months[month].count > 0;
+    if (!hasData)
+    {
+        out << year << ": No Data\n";
+        return;
+    }
+
+    out << year << '\n';
+    for (int month = 1; month <= 12; month++)
+    {
+        const SolarStats& stats = months[month - 1];
+        if (stats.measured > 0)
+            out << Date().SetMonthName(month) << ": " << stats.total << " kWh/m2\n";
         else
-            cout << Date().SetMonthName(month) << ": No Data" << endl;
+            out << Date().SetMonthName(month) << ": No Data\n";
     }
 }
 
 double Weather::calculateMAD(Bst<float>& bst, double mean)
 {
-    Vector<float> values = bstToVector(bst);
-    if (values.isEmpty())
+    size_t count = bst.count();
+    if (count == 0)
         return 0;
     double sumAbsDiff = 0;
-    for (int i = 0; i < values.size(); i++)
+    bst.inOrderCounted([&sumAbsDiff, mean](float value, size_t copies)
     {
-        sumAbsDiff += abs(values[i] - mean);
-    }
-    return sumAbsDiff / values.size();
+        sumAbsDiff += abs(value - mean) * copies;
+    });
+    return sumAbsDiff / count;
 }
 
 void Weather::writeWindTempSolar(int year)
 {
-    ofstream outFile("WindTempSolar.csv");
-    if (!outFile)
+    if (!writeWindTempSolarFile("WindTempSolar.csv", year))
     {
         cout << "Error: Could not create output file WindTempSolar.csv" << endl;
         return;
     }
+    cout << "Data has been written to WindTempSolar.csv" << endl;
+}
 
-    Vector<WeatherData> yearData = getDataForYear(year);
-    if (yearData.isEmpty())
+bool Weather::writeWindTempSolarFile(const string& filename, int year)
+{
+    vector<ReportMonth> months = collectReportMonths(year, year);
+    return writeReportFile(filename, year, months.data());
+}
+
+void Weather::writeWindTempSolarRange(int firstYear, int lastYear)
+{
+    if (!isReportableYearRange(firstYear, lastYear))
+        return;
+
+    size_t years = static_cast<size_t>(static_cast<int64_t>(lastYear) - firstYear + 1);
+    vector<ReportMonth> months = collectReportMonths(firstYear, lastYear);
+
+    // Write one file per year, one task per year
+    vector<char> written(years, 0);
+    TaskScheduler::shared().parallelFor(0, years, 1, [&](size_t first, size_t last)
+    {
+        for (size_t y = first; y < last; y++)
+        {
+            int year = firstYear + static_cast<int>(y);
+            written[y] = writeReportFile("WindTempSolar_" + to_string(year) + ".csv", year, &months[y * 12]);
+        }
+    });
+
+    for (size_t y = 0; y < years; y++)
     {
-        outFile << year << endl << "No Data" << endl;
-        outFile.close();
+        int year = firstYear + static_cast<int>(y);
+        if (written[y])
+            cout << "Data has been written to WindTempSolar_" << year << ".csv" << endl;
+        else
+            cout << "Error: Could not create output file WindTempSolar_" << year << ".csv" << endl;
+    }
+}
+
+void Weather::exportDataArrow(const string& filename)
+{
+    const size_t batchRows = 1 << 20;  // About 16 MB of columns per record batch
+    vector<ArrowColumn> columns;
+    columns.emplace_back("timestamp", ArrowType::TimestampSecond, false);
+    columns.emplace_back("wind_speed", ArrowType::Float32, false);
+    columns.emplace_back("temperature", ArrowType::Float32, false);
+    columns.emplace_back("solar_radiation", ArrowType::Float32, true);
+
+    ArrowFileWriter outFile(filename, columns);
+    for (size_t start = 0; start < m_data.size() && outFile.isOpen(); start += batchRows)
+    {
+        for (ArrowColumn& column : columns)
+            column.clear();
+        size_t end = std::min(m_data.size(), start + batchRows);
+        for (size_t i = start; i < end; i++)
+        {
+            const WeatherData& data = m_data[i];
+            int64_t seconds = static_cast<int64_t>(data.date.GetSerial()) * 86400
+                              + data.time.GetHour() * 3600 + data.time.GetMinute() * 60;
+            columns[0].append(seconds);
+            columns[1].append(data.windSpeed);
+            columns[2].append(data.temperature);
+            if (data.solarRadiation >= 100)
+                columns[3].append(data.solarRadiation);
+            else
+                columns[3].appendNull();
+        }
+        outFile.writeBatch(columns);
+    }
+
+    if (!outFile.close())
+    {
+        cout << "Error: Could not write output file " << filename << endl;
         return;
     }
+    cout << "Data has been written to " << filename << endl;
+}
 
-    // Write the year header
-    outFile << year << endl;
-    outFile << "Month,\"Average Wind Speed(stdev, mad)\",\"Average Ambient Temperature(stdev, mad)\",Solar Radiation" << endl;
+void Weather::exportMonthlyArrow(const string& filename, int firstYear, int lastYear)
+{
+    if (!isReportableYearRange(firstYear, lastYear))
+        return;
 
-    // Process each month
-    for (int month = 1; month <= 12; month++)
+    vector<ArrowColumn> columns;
+    columns.emplace_back("year", ArrowType::Int32, false);
+    columns.emplace_back("month", ArrowType::Int32, false);
+    columns.emplace_back("month_name", ArrowType::Utf8, false);
+    columns.emplace_back("records", ArrowType::Int64, false);
+    columns.emplace_back("wind_speed_mean", ArrowType::Float64, true);
+    columns.emplace_back("wind_speed_stdev", ArrowType::Float64, true);
+    columns.emplace_back("wind_speed_mad", ArrowType::Float64, true);
+    columns.emplace_back("temperature_mean", ArrowType::Float64, false);
+    columns.emplace_back("temperature_stdev", ArrowType::Float64, false);
+    columns.emplace_back("temperature_mad", ArrowType::Float64, false);
+    columns.emplace_back("solar_radiation", ArrowType::Float64, true);
+
+    vector<ReportMonth> months = collectReportMonths(firstYear, lastYear);
+    for (size_t m = 0; m < months.size(); m++)
     {
-        Vector<WeatherData> monthData = getDataForMonth(month, year);
-        if (monthData.isEmpty()) continue; // Skip months with no data
+        ReportMonth& data = months[m];
+        if (data.temperatures.empty()) continue; // Skip months with no data
 
-        Bst<float> windSpeedBst;
-        Bst<float> temperatureBst;
-        float totalRadiation = 0.0f;
-        bool hasWind = false, hasTemp = false, hasSolar = false;
+        int month = static_cast<int>(m % 12) + 1;
+        columns[0].append<int32_t>(firstYear + static_cast<int>(m / 12));
+        columns[1].append<int32_t>(month);
+        columns[2].appendString(Date().SetMonthName(month));
+        columns[3].append<int64_t>(static_cast<int64_t>(data.temperatures.size()));
 
-        // Collect data for the month
-        for (int i = 0; i < monthData.size(); i++)
+        const MonthStats& wind = data.wind;
+        if (wind.count == 0)
         {
-            // Wind speed
-            if (monthData[i].windSpeed >= 0)
-            {
-                windSpeedBst.insert(monthData[i].windSpeed * 3.6); // Convert to km/h
-                hasWind = true;
-            }
+            for (int c = 4; c <= 6; c++)
+                columns[c].appendNull();
+        } else
+        {
+            columns[4].append(wind.mean);
+            columns[5].append(wind.stdev);
+            columns[6].append(wind.mad);
+        }
 
-            // Temperature
-            temperatureBst.insert(monthData[i].temperature);
-            hasTemp = true;
+        const MonthStats& temperature = data.temperature;
+        columns[7].append(temperature.mean);
+        columns[8].append(temperature.stdev);
+        columns[9].append(temperature.mad);
 
-            // Solar radiation
-            if (monthData[i].solarRadiation >= 100)
-            {
-                totalRadiation += (monthData[i].solarRadiation / 1000.0f); // Convert to kWh/m2
-                hasSolar = true;
-            }
+        if (data.hasSolar)
+            columns[10].append(static_cast<double>(data.totalRadiation));
+        else
+            columns[10].appendNull();
+    }
+
+    ArrowFileWriter outFile(filename, columns);
+    if (columns[0].size() > 0)
+        outFile.writeBatch(columns);
+    if (!outFile.close())
+    {
+        cout << "Error: Could not write output file " << filename << endl;
+        return;
+    }
+    cout << "Data has been written to " << filename << endl;
+}
+
+vector<Weather::ReportMonth> Weather::collectReportMonths(int firstYear, int lastYear)
+{
+    // Collect every month of every year in a single pass over the data
+    vector<ReportMonth> months(static_cast<size_t>(static_cast<int64_t>(lastYear) - firstYear + 1) * 12);
+    for (size_t i = 0; i < m_data.size(); i++)
+    {
+        const WeatherData& data = m_data[i];
+        int year = data.date.GetYear();
+        if (year >= firstYear && year <= lastYear)
+            addToReportMonth(months[static_cast<size_t>(year - firstYear) * 12 + data.date.GetMonth() - 1], data);
+    }
+
+    // Summarize the months in parallel, some are empty and others hold thousands of values
+    TaskScheduler::shared().parallelFor(0, months.size(), 1, [&](size_t first, size_t last)
+    {
+        for (size_t m = first; m < last; m++)
+        {
+            months[m].wind = summarize(months[m].windSpeeds);
+            months[m].temperature = summarize(months[m].temperatures);
         }
+    });
+    return months;
+}
+
+bool Weather::isReportableYearRange(int firstYear, int lastYear)
+{
+    if (firstYear > lastYear)
+    {
+        cout << "Error: The first year must not be after the last year." << endl;
+        return false;
+    }
+    if (static_cast<int64_t>(lastYear) - firstYear + 1 > MAX_REPORT_YEARS)
+    {
+        cout << "Error: A report can cover at most " << MAX_REPORT_YEARS << " years." << endl;
+        return false;
+    }
+    return true;
+}
+
+void Weather::addToReportMonth(ReportMonth& month, const WeatherData& data)
+{
+    // Wind speed
+    if (data.windSpeed >= 0)
+        month.windSpeeds.push_back(data.windSpeed * 3.6); // Convert to km/h
+
+    // Temperature
+    month.temperatures.push_back(data.temperature);
+
+    // Solar radiation
+    if (data.solarRadiation >= 100)
+    {
+        month.totalRadiation += (data.solarRadiation / 1000.0f); // Convert to kWh/m2
+        month.hasSolar = true;
+    }
+}
+
+bool Weather::writeReportFile(const string& filename, int year, ReportMonth* months)
+{
+    ReportWriter outFile(filename);
+    if (!outFile.isOpen())
+        return false;
+
+    bool hasData = false;
+    for (int month = 0; month < 12; month++)
+        hasData |= !months[month].temperatures.empty(); // Every record has a temperature
+    if (!hasData)
+    {
+        outFile << year << "\nNo Data\n";
+        return outFile.close();
+    }
+
+    // Write the year header
+    outFile << year << '\n';
+    outFile.field("Month");
+    outFile << ',';
+    outFile.field("Average Wind Speed(stdev, mad)");
+    outFile << ',';
+    outFile.field("Average Ambient Temperature(stdev, mad)");
+    outFile << ',';
+    outFile.field("Solar Radiation");
+    outFile << '\n';
+
+    // Process each month
+    for (int month = 1; month <= 12; month++)
+    {
+        ReportMonth& data = months[month - 1];
+        if (data.temperatures.empty()) continue; // Skip months with no data
+
+        const MonthStats& wind = data.wind;
+        const MonthStats& temperature = data.temperature;
 
         // Calculate statistics and write to file
-        outFile << Date().SetMonthName(month) << ",";
+        outFile.field(Date().SetMonthName(month));
+        outFile << ',';
 
         // Wind speed stats
-        if (hasWind)
+        if (wind.count > 0)
         {
-            double windMean = calculateMean(windSpeedBst);
-            double windStdev = calculateStdev(windSpeedBst, windMean);
-            double windMAD = calculateMAD(windSpeedBst, windMean);
-            outFile << "\"" << windMean << "(" << windStdev << ", " << windMAD << ")\"";
+            outFile.beginField();
+            outFile << wind.mean << '(' << wind.stdev << ", " << wind.mad << ')';
+            outFile.endField();  // Quoted, it contains a comma
         }
-        outFile << ",";
+        outFile << ',';
 
         // Temperature stats
-        if (hasTemp)
-        {
-            double tempMean = calculateMean(temperatureBst);
-            double tempStdev = calculateStdev(temperatureBst, tempMean);
-            double tempMAD = calculateMAD(temperatureBst, tempMean);
-            outFile << "\"" << tempMean << "(" << tempStdev << ", " << tempMAD << ")\"";
-        }
-        outFile << ",";
+        outFile.beginField();
+        outFile << temperature.mean << '(' << temperature.stdev << ", " << temperature.mad << ')';
+        outFile.endField();
+        outFile << ',';
 
         // Solar radiation
-        if (hasSolar)
-            outFile << totalRadiation;
+        if (data.hasSolar)
+            outFile << data.totalRadiation;
 
-        outFile << endl;
+        outFile << '\n';
     }
-
-    outFile.close();
-    cout << "Data has been written to WindTempSolar.csv" << endl;
+    return outFile.close();
 }
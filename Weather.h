@@ -4,11 +4,23 @@
 #include "date.h"
 #include "time.h"
 #include "vector.h"
+#include "SegmentedVector.h"
+#include "AlignedAllocator.h"
+#include "WastParser.h"
+#include "ReportWriter.h"
+#include "ArrowWriter.h"
+#include "ResultCache.h"
+#include "ChunkReader.h"
+#include "TaskScheduler.h"
+#include "Generator.h"
 #include <string>
 #include <iostream>
 #include <fstream>
 #include <cmath>
 #include <map>
+#include <array>
+#include <vector>
+#include <mutex>
 #include "bst.h"
 
 using std::ifstream;
@@ -32,6 +44,43 @@ struct WeatherData
     float solarRadiation;   ///< Solar radiation in W/m
 };
 
+/**
+ * @struct MonthStats
+ * @brief Summary statistics of one measurement over a month
+ *
+ * A month without data has a `count` of 0 and every statistic 0.
+ */
+struct MonthStats
+{
+    size_t count = 0;   ///< Number of values
+    double mean = 0;    ///< Mean of the values
+    double stdev = 0;   ///< Sample standard deviation of the values
+    double mad = 0;     ///< Mean absolute deviation of the values from the mean
+};
+
+/**
+ * @struct SolarStats
+ * @brief Total solar radiation of a month
+ */
+struct SolarStats
+{
+    size_t count = 0;      ///< Number of records in the month
+    size_t measured = 0;   ///< Number of records with a solar radiation of at least 100 W/m2
+    double total = 0;      ///< Sum of those solar radiations, in kWh/m2
+};
+
+/**
+ * @struct CorrelationResult
+ * @brief Sample Pearson correlation coefficients between the measurements of a month
+ */
+struct CorrelationResult
+{
+    size_t count = 0;              ///< Number of records, over all years
+    double windTemperature = 0;    ///< Wind speed against temperature (S_T)
+    double windSolar = 0;          ///< Wind speed against solar radiation (S_R)
+    double temperatureSolar = 0;   ///< Temperature against solar radiation (T_R)
+};
+
 /**
  * @class Weather
  * @brief Class for managing and processing weather data
@@ -60,12 +109,59 @@ public:
      * @brief Loads weather data from a file
      *
      * Reads weather data from the specified file and populates the internal data structure.
+     * The file is read ahead on a separate thread while its lines are parsed (see `ChunkReader`).
+     * Results of earlier queries are no longer used once the file is loaded.
      *
      * @param filename The name of the file containing weather data.
      * @return `true` if data was successfully loaded, `false` otherwise.
      */
     bool loadDataFromFile(const string& filename);
 
+    /**
+     * @brief Loads several weather data files at once
+     *
+     * The files are parsed in parallel on the shared `TaskScheduler`, then their records are
+     * copied in parallel, in the order of the files, as if each had been loaded with
+     * `loadDataFromFile`.
+     *
+     * @param filenames The names of the files containing weather data.
+     * @param messages Receives, for each file, the errors and warnings `loadDataFromFile` would print.
+     * @return For each file, whether its data was successfully loaded.
+     */
+    vector<char> loadDataFromFiles(const vector<string>& filenames, vector<string>& messages);
+
+    /**
+     * @brief Reads the records of a weather data file lazily, one at a time
+     *
+     * Each record is parsed only when the consumer asks for it, and nothing is added to the
+     * loaded data, so stages such as `Generator::takeWhile` can stop reading a file early.
+     * Rows are checked and parsed as by `loadDataFromFile`.
+     *
+     * @param filename The name of the file containing weather data.
+     * @param log Receives the errors and warnings; warnings only once the whole file is read.
+     * @param ok Set to `true` once the header is read, back to `false` if reading the file fails.
+     *           Must outlive the generator.
+     * @return A generator of the records, in the order of the file.
+     */
+    static Generator<WeatherData> readRecords(string filename, std::ostream& log, bool& ok);
+
+    /**
+     * @brief Calculates the wind speed statistics of a month straight from a data file
+     *
+     * Streams the file through a pipeline of `readRecords` stages rather than loading it: the
+     * records before the month are skipped, reading stops at the first record after the month,
+     * and only the wind speeds of the month are kept. The file must be in chronological order,
+     * as the station writes it.
+     *
+     * @param filename The name of the file containing weather data.
+     * @param month The month (1-12).
+     * @param year The year.
+     * @param stats Receives the statistics of the wind speed in km/h.
+     * @param log Receives the errors.
+     * @return `true` if the file could be read, `false` otherwise.
+     */
+    bool fileWindStats(const string& filename, int month, int year, MonthStats& stats, std::ostream& log);
+
     /**
      * @brief Calculates wind statistics for a specified month and year
      *
@@ -107,6 +203,56 @@ public:
      */
     void writeWindTempSolar(int year);
 
+    /**
+     * @brief Writes the wind, temperature, and solar radiation report of one year to a given file
+     *
+     * Writes the same report as `writeWindTempSolar`, without printing anything.
+     *
+     * @param filename The name of the file to write.
+     * @param year The year of the report.
+     * @return `true` if the file was written, `false` if it could not be created or written.
+     */
+    bool writeWindTempSolarFile(const string& filename, int year);
+
+    /**
+     * @brief Writes the wind, temperature, and solar radiation report for a range of years
+     *
+     * Collects every month of every year in the range in a single pass over the data, then
+     * writes one file per year, `WindTempSolar_<year>.csv`, with several files written at once
+     * on the shared `TaskScheduler`.
+     * Each file has the same layout as the one written by `writeWindTempSolar`.
+     * Ranges of more than `MAX_REPORT_YEARS` years are rejected with an error message.
+     *
+     * @param firstYear The first year of the range.
+     * @param lastYear The last year of the range, included.
+     */
+    void writeWindTempSolarRange(int firstYear, int lastYear);
+
+    /**
+     * @brief Exports every weather record to an Arrow IPC file
+     *
+     * Writes the timestamp, wind speed, temperature, and solar radiation of every record as
+     * columns of an Apache Arrow file, so other tools can memory-map the data without parsing
+     * it. Solar radiation below 100 W/m2, which is not recorded, is exported as null.
+     *
+     * @param filename The name of the file to write.
+     */
+    void exportDataArrow(const string& filename);
+
+    /**
+     * @brief Exports the monthly statistics for a range of years to an Arrow IPC file
+     *
+     * Writes one row per month with data: the mean, standard deviation, and mean absolute
+     * deviation of wind speed (km/h) and temperature, and the total solar radiation (kWh/m2),
+     * as in the report written by `writeWindTempSolar`. Statistics without data are null.
+     * Ranges of more than `MAX_REPORT_YEARS` years are rejected with an error message.
+     *
+     * @param filename The name of the file to write.
+     * @param firstYear The first year of the range.
+     * @param lastYear The last year of the range, included.
+     */
+    void exportMonthlyArrow(const string& filename, int firstYear, int lastYear);
+
     /**
      * @brief Calculates the Spearman's rank correlation coefficient (SPCC) for a given month
      *
@@ -116,29 +262,131 @@ public:
      */
     void calculateSPCCForMonth(int month);
 
-private:
-    Vector<WeatherData> m_data;  ///< Vector holding all the weather data
+    /**
+     * @brief Gets the wind speed statistics of a month
+     *
+     * Results are cached, so repeating a query does not scan the data again until more data is loaded.
+     * No text is formatted or printed. Like the other statistics queries, it may run on several
+     * threads at once, as long as no data is loaded meanwhile.
+     *
+     * @param month The month (1-12).
+     * @param year The year.
+     * @return The statistics of the wind speed in km/h.
+     */
+    MonthStats windStats(int month, int year);
+
+    /**
+     * @brief Gets the temperature statistics of every month of a year
+     *
+     * @param year The year.
+     * @return The statistics of the temperature of each month, January first.
+     */
+    std::array<MonthStats, 12> temperatureStats(int year);
+
+    /**
+     * @brief Gets the total solar radiation of every month of a year
+     *
+     * @param year The year.
+     * @return The solar radiation of each month, January first.
+     */
+    std::array<SolarStats, 12> solarRadiationStats(int year);
+
+    /**
+     * @brief Gets the correlation coefficients between the measurements of a month over all years
+     *
+     * @param month The month (1-12).
+     * @return The correlation coefficients.
+     */
+    CorrelationResult correlation(int month);
+
+    /**
+     * @brief Writes wind speed statistics as printed by `calculateWindStats`
+     *
+     * @param out The writer receiving the text.
+     * @param month The month (1-12) of the statistics.
+     * @param year The year of the statistics.
+     * @param stats The statistics.
+     */
+    static void formatWindStats(ReportWriter& out, int month, int year, const MonthStats& stats);
+
+    /**
+     * @brief Writes temperature statistics as printed by `calculateTempStats`
+     *
+     * @param out The writer receiving the text.
+     * @param year The year of the statistics.
+     * @param months The statistics of each month, January first.
+     */
+    static void formatTempStats(ReportWriter& out, int year, const std::array<MonthStats, 12>& months);
 
     /**
-     * @brief Converts a binary search tree (BST) to a vector
+     * @brief Writes solar radiation totals as printed by `calculateSolarRadiation`
      *
-     * Converts a binary search tree containing weather data (such as wind speed or temperature)
-     * into a vector for easier processing.
+     * @param out The writer receiving the text.
+     * @param year The year of the totals.
+     * @param months The solar radiation of each month, January first.
+     */
+    static void formatSolarRadiation(ReportWriter& out, int year, const std::array<SolarStats, 12>& months);
+
+    /**
+     * @brief Writes correlation coefficients as printed by `calculateSPCCForMonth`
      *
-     * @param bst The binary search tree to convert.
-     * @return A vector containing the elements of the BST.
+     * @param out The writer receiving the text.
+     * @param month The month (1-12) of the coefficients.
+     * @param result The coefficients.
+     */
+    static void formatCorrelation(ReportWriter& out, int month, const CorrelationResult& result);
+
+private:
+    static const size_t QUERY_CACHE_SIZE = 64;  ///< Number of query results kept of each kind
+    static const size_t SCAN_GRAIN = 16384;     ///< Fewest records scanned by one task
+    static const int MAX_REPORT_YEARS = 1000;   ///< Most years covered by one range report
+
+    /**
+     * @struct ReportMonth
+     * @brief Values of one month collected for the wind, temperature, and solar radiation report
      */
-    Vector<float> bstToVector(Bst<float>& bst) const;
+    struct ReportMonth
+    {
+        vector<float> windSpeeds;    ///< Wind speeds in km/h
+        vector<float> temperatures;  ///< Temperatures, one per record
+        float totalRadiation = 0.0f; ///< Solar radiation of at least 100 W/m2, in kWh/m2
+        bool hasSolar = false;       ///< Whether any solar radiation was counted
+        MonthStats wind;             ///< Statistics of `windSpeeds`
+        MonthStats temperature;      ///< Statistics of `temperatures`
+    };
+
+    /// Chunked storage of weather records, never relocated while loading, one huge page per chunk
+    typedef SegmentedVector<WeatherData, AlignedAllocator<WeatherData>> DataStore;
+
+    DataStore m_data; ///< All the weather data
+
+    uint64_t m_dataVersion; ///< Incremented on every load, so cached results never go stale; guarded by `m_cacheMutex`
+
+    ResultCache<uint64_t, MonthStats> m_windCache;                        ///< Wind statistics, by month and year
+    ResultCache<uint64_t, std::array<MonthStats, 12>> m_temperatureCache; ///< Temperature statistics, by year
+    ResultCache<uint64_t, std::array<SolarStats, 12>> m_solarCache;       ///< Solar radiation totals, by year
+    ResultCache<uint64_t, CorrelationResult> m_correlationCache;          ///< Correlations, by month
+    std::mutex m_cacheMutex;                                              ///< Guards the caches, queries may run on several threads
 
     /**
-     * @brief Traverses a BST in-order and adds elements to a vector
+     * @brief Reads every record of a weather data file
+     *
+     * Drains `readRecords`. Touches no member, so several files can be parsed at once.
      *
-     * Recursively traverses a binary search tree in-order and adds the elements to a vector.
+     * @param filename The name of the file containing weather data.
+     * @param records Receives the records of the file.
+     * @param log Receives the errors and warnings.
+     * @return `true` if the file was read, `false` if it could not be read or lacks a column.
+     */
+    static bool parseDataFile(const string& filename, DataStore& records, std::ostream& log);
+
+    /**
+     * @brief Calculates the mean, standard deviation, and mean absolute deviation of some values
      *
-     * @param node The current node of the BST.
-     * @param vec The vector to store the elements.
+     * @param values The values.
+     * @return The statistics, all 0 if there are no values.
      */
-    void inOrderToVector(Node<float>* node, Vector<float>& vec) const;
+    MonthStats summarize(const vector<float>& values);
 
     /**
      * @brief Calculates the mean of a binary search tree (BST)
@@ -203,6 +451,47 @@ private:
      * @return A vector containing the weather data for the specified year.
      */
     Vector<WeatherData> getDataForYear(int year);
+
+    /**
+     * @brief Adds a record to the values of its month for the report
+     *
+     * @param month The values collected for the month of the record.
+     * @param data The record to add.
+     */
+    static void addToReportMonth(ReportMonth& month, const WeatherData& data);
+
+    /**
+     * @brief Collects the report values of every month of a range of years in one pass
+     *
+     * The statistics of the months are then calculated in parallel.
+     *
+     * @param firstYear The first year of the range.
+     * @param lastYear The last year of the range, included.
+     * @return Twelve months per year, January of the first year first.
+     */
+    vector<ReportMonth> collectReportMonths(int firstYear, int lastYear);
+
+    /**
+     * @brief Checks that a range of years can be reported, printing an error if not
+     *
+     * The number of years is computed in 64 bits, so ranges spanning most of `int` are
+     * rejected rather than overflowing.
+     *
+     * @param firstYear The first year of the range.
+     * @param lastYear The last year of the range, included.
+     * @return true if the range is ordered and covers at most `MAX_REPORT_YEARS` years.
+     */
+    static bool isReportableYearRange(int firstYear, int lastYear);
+
+    /**
+     * @brief Writes the wind, temperature, and solar radiation report of one year to a file
+     *
+     * @param filename The name of the file to write.
+     * @param year The year of the report.
+     * @param months The values collected for the twelve months of the year, January first.
+     * @return `true` if the file was written, `false` if it could not be created or written.
+     */
+    bool writeReportFile(const string& filename, int year, ReportMonth* months);
 };
 
 #endif // WEATHER_H_INCLUDED
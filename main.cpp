@@ -1,17 +1,31 @@
 #include "weather.h"
+#include "BatchRunner.h"
+#include "QueryServer.h"
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
 using std::cin;
 using std::cout;
 using std::endl;
 using std::string;
+using std::vector;
 
 bool loadDataFiles(Weather& analyzer);
 void displayMenu();
+int runBatch(int argc, char* argv[]);
+int runServer(int argc, char* argv[]);
 
-int main()
+int main(int argc, char* argv[])
 {
+    // Any argument selects batch or server mode, which never read the menu from the keyboard
+    if (argc > 1 && string(argv[1]) == "--serve")
+        return runServer(argc, argv);
+    if (argc > 1)
+        return runBatch(argc, argv);
+
     Weather analyzer;
 
     // Load all data files before showing menu
@@ -104,6 +118,43 @@ int main()
                 break;
             }
             case 5:
+            {
+                int firstYear, lastYear;
+                cout << "Enter first year: ";
+                cin >> firstYear;
+                cout << "Enter last year: ";
+                cin >> lastYear;
+                if (cin.fail() || firstYear > lastYear)
+                {
+                    cout << "Invalid input. Please enter two years in increasing order." << endl;
+                    cin.clear();
+                    cin.ignore(10000, '\n');
+                } else
+                    analyzer.writeWindTempSolarRange(firstYear, lastYear);
+                cout << endl;
+                break;
+            }
+            case 6:
+            {
+                int firstYear, lastYear;
+                cout << "Enter first year: ";
+                cin >> firstYear;
+                cout << "Enter last year: ";
+                cin >> lastYear;
+                if (cin.fail() || firstYear > lastYear)
+                {
+                    cout << "Invalid input. Please enter two years in increasing order." << endl;
+                    cin.clear();
+                    cin.ignore(10000, '\n');
+                } else
+                {
+                    analyzer.exportDataArrow("WeatherData.arrow");
+                    analyzer.exportMonthlyArrow("MonthlyStats.arrow", firstYear, lastYear);
+                }
+                cout << endl;
+                break;
+            }
+            case 7:
                 cout << "Exiting program." << endl;
                 return 0;
             default:
@@ -119,8 +170,10 @@ void displayMenu()
     cout << "2. Temperature statistics for a year" << endl;
     cout << "3. Calculate Sample Pearson Correlation Coefficient (sPCC) for a specific month" << endl;
     cout << "4. Generate comprehensive report (WindTempSolar.csv)" << endl;
-    cout << "5. Exit" << endl;
-    cout << "Enter your choice (1-5): ";
+    cout << "5. Generate comprehensive reports for a range of years (WindTempSolar_<year>.csv)" << endl;
+    cout << "6. Export data and monthly statistics for a range of years (WeatherData.arrow, MonthlyStats.arrow)" << endl;
+    cout << "7. Exit" << endl;
+    cout << "Enter your choice (1-7): ";
 }
 
 bool loadDataFiles(Weather& analyzer)
@@ -134,17 +187,24 @@ bool loadDataFiles(Weather& analyzer)
         return false;
     }
 
+    vector<string> filenames;
+    vector<string> paths;
     string filename;
-    bool atLeastOneFileLoaded = false;
-
     while (std::getline(sourceFile, filename))
     {
         if (filename.empty()) continue;
+        filenames.push_back(filename);
+        paths.push_back("data/" + filename);
+    }
 
-        string fullPath = "data/" + filename;
-        cout << "Loading " << filename << "... ";
-
-        if (analyzer.loadDataFromFile(fullPath))
+    // The files are parsed in parallel, then reported in order
+    vector<string> messages;
+    vector<char> loaded = analyzer.loadDataFromFiles(paths, messages);
+    bool atLeastOneFileLoaded = false;
+    for (size_t i = 0; i < filenames.size(); i++)
+    {
+        cout << "Loading " << filenames[i] << "... " << messages[i];
+        if (loaded[i])
         {
             cout << "Success" << endl;
             atLeastOneFileLoaded = true;
@@ -155,3 +215,101 @@ bool loadDataFiles(Weather& analyzer)
     sourceFile.close();
     return atLeastOneFileLoaded;
 }
+
+/**
+ * @brief Runs the queries given on the command line and exits
+ *
+ * Usage: `weather [-f <query file>]... [<query>]...`, where each query is one argument, e.g.
+ * `weather "wind 3 2015" "temp 2015"`, and a query file holds one query per line (`-` reads
+ * them from the standard input). Results are written to the standard output as one JSON line
+ * per query; progress and errors go to the standard error, so the output can be piped.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return 0 if every query succeeded, 1 otherwise.
+ */
+int runBatch(int argc, char* argv[])
+{
+    // Everything the loader prints is progress, keep the standard output for results
+    std::streambuf* console = cout.rdbuf(std::cerr.rdbuf());
+
+    Weather analyzer;
+    BatchRunner batch(analyzer);
+    for (int i = 1; i < argc; i++)
+    {
+        string argument = argv[i];
+        if (argument == "-h" || argument == "--help")
+        {
+            cout.rdbuf(console);
+            cout << "Usage: " << argv[0] << " [-f <query file>]... [<query>]..." << endl;
+            cout << "   or: " << argv[0] << " --serve <socket path> [<worker count>]" << endl;
+            cout << "Queries: wind <month> <year>, scan <month> <year> <file>, temp <year>, solar <year>, spcc <month>,"
+                 << " report <year>" << endl;
+            return 0;
+        }
+        if (argument == "-f")
+        {
+            if (i + 1 == argc || !batch.addQueryFile(argv[++i]))
+            {
+                cout << "Error: Cannot read query file " << (i < argc ? argv[i] : "") << endl;
+                cout.rdbuf(console);
+                return 1;
+            }
+        } else
+            batch.addQuery(argument);
+    }
+
+    if (!loadDataFiles(analyzer))
+    {
+        cout << "Failed to load any weather data files. Exiting." << endl;
+        cout.rdbuf(console);
+        return 1;
+    }
+
+    ReportWriter out(stdout);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t failed = batch.run(out);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    cout << "Ran " << batch.size() << " queries in " << elapsed.count() << " ms, " << failed << " failed" << endl;
+
+    cout.rdbuf(console);
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Loads the data once and serves queries over a Unix domain socket until interrupted
+ *
+ * Usage: `weather --serve <socket path> [<worker count>]`. Clients send the queries of batch
+ * mode, one per line, and read one JSON line per query, e.g. with
+ * `echo "wind 3 2015" | socat - UNIX-CONNECT:<socket path>`.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return 0 once stopped by SIGINT or SIGTERM, 1 if the server could not start.
+ */
+int runServer(int argc, char* argv[])
+{
+    if (argc < 3 || argc > 4)
+    {
+        cout << "Usage: " << argv[0] << " --serve <socket path> [<worker count>]" << endl;
+        return 1;
+    }
+    int workerCount = argc == 4 ? std::atoi(argv[3]) : 0;
+    if (workerCount < 0)
+        workerCount = 0;
+    TaskScheduler::setSharedWorkerCount(static_cast<size_t>(workerCount)); // Before loading starts the workers
+
+    Weather analyzer;
+    cout << "Loading weather data files..." << endl;
+    if (!loadDataFiles(analyzer))
+    {
+        cout << "Failed to load any weather data files. Exiting." << endl;
+        return 1;
+    }
+
+    QueryServer server(analyzer, argv[2]);
+    if (!server.run())
+        return 1;
+    cout << "Server stopped." << endl;
+    return 0;
+}